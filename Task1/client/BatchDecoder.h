@@ -0,0 +1,199 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <zmq.hpp>
+
+#include "../common/Parallel.h"
+#include "../common/Student.h"
+#include "SpscQueue.h"
+#include "StudentSnapshot.h"
+
+// Разбор пакетов потоковой публикации в пуле потоков. Поток приема
+// передает пакеты по порядку (push), не дожидаясь разбора: у каждого
+// потока разбора своя ограниченная очередь SPSC без блокировок, пакеты
+// раздаются по кругу. Пустая и заполненная очередь ждут уведомления, а не
+// опрашиваются. Разобранные пакеты собираются в снимок в порядке
+// передачи (finish). Заполненная очередь задерживает поток приема, и
+// непринятые сообщения остаются в буфере ZeroMQ. Все методы, кроме
+// обработчика записей, вызываются из одного потока (потока приема)
+class BatchDecoder {
+ public:
+  // Обработчик записей разобранного пакета. Вызывается из потоков разбора
+  // (вызовы не пересекаются, порядок пакетов не гарантирован); записи
+  // действительны только во время вызова
+  using RecordHandler = std::function<void(const std::vector<StudentView>&)>;
+
+  // Пакетов в очереди одного потока разбора
+  static constexpr size_t QUEUE_CAPACITY = 16;
+
+  // threadCount — потоков разбора; 0 — по числу ядер. Потоки создаются
+  // при первом begin()
+  explicit BatchDecoder(unsigned threadCount = 0)
+      : threadCount_(threadCount > 0 ? threadCount : defaultThreadCount()) {}
+
+  ~BatchDecoder() { stop(); }
+
+  BatchDecoder(const BatchDecoder&) = delete;
+  BatchDecoder& operator=(const BatchDecoder&) = delete;
+
+  // Задается до begin()
+  void setRecordHandler(RecordHandler handler) {
+    handler_ = std::move(handler);
+  }
+
+  // Новая публикация не больше чем из batchCount пакетов. Пакеты прежней
+  // публикации дожидаются разбора и отбрасываются
+  void begin(size_t batchCount) {
+    startWorkers();
+    wait();
+    results_.clear();
+    results_.resize(batchCount);
+    pushed_ = 0;
+    decoded_ = 0;
+  }
+
+  // Передача следующего по порядку пакета на разбор
+  void push(zmq::message_t&& batch) {
+    if (pushed_ >= results_.size()) {
+      return;
+    }
+
+    Task task{pushed_, std::move(batch)};
+    Worker& worker = *workers_[pushed_ % workers_.size()];
+    pushed_++;
+    {
+      std::unique_lock<std::mutex> lock(worker.mutex);
+      worker.space.wait(lock, [&] { return !worker.queue.full(); });
+    }
+    worker.queue.tryPush(task);
+    {
+      std::lock_guard<std::mutex> lock(worker.mutex);
+      worker.ready.notify_one();
+    }
+  }
+
+  size_t pushed() const { return pushed_; }
+
+  // Ожидание разбора всех переданных пакетов; снимок из них в порядке
+  // передачи. После finish() — begin() для следующей публикации
+  StudentSnapshot finish() {
+    wait();
+    StudentSnapshot snapshot;
+    for (size_t i = 0; i < pushed_; ++i) {
+      snapshot.appendDecoded(std::move(results_[i]));
+    }
+    results_.clear();
+    pushed_ = 0;
+    decoded_ = 0;
+    return snapshot;
+  }
+
+ private:
+  struct Task {
+    size_t index = 0;
+    zmq::message_t message;
+  };
+
+  // Поток разбора и его очередь. Поток разбора ждет пакетов на ready,
+  // поток приема при заполненной очереди — места на space. Оба
+  // уведомляются под mutex: проверка очереди и засыпание под тем же
+  // mutex не разминутся с уведомлением
+  struct Worker {
+    Worker() : queue(QUEUE_CAPACITY) {}
+
+    SpscQueue<Task> queue;
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::condition_variable space;
+    std::thread thread;
+  };
+
+  void startWorkers() {
+    if (!workers_.empty()) {
+      return;
+    }
+    stopping_ = false;
+    for (unsigned i = 0; i < threadCount_; ++i) {
+      workers_.push_back(std::make_unique<Worker>());
+    }
+    for (auto& worker : workers_) {
+      worker->thread = std::thread(&BatchDecoder::run, this, worker.get());
+    }
+  }
+
+  void stop() {
+    stopping_ = true;
+    for (auto& worker : workers_) {
+      std::lock_guard<std::mutex> lock(worker->mutex);
+      worker->ready.notify_one();
+    }
+    for (auto& worker : workers_) {
+      if (worker->thread.joinable()) {
+        worker->thread.join();
+      }
+    }
+    workers_.clear();
+  }
+
+  // Разбор пакетов очереди; после stop() — оставшихся в ней
+  void run(Worker* worker) {
+    Task task;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(worker->mutex);
+        worker->ready.wait(lock, [&] {
+          return !worker->queue.empty() || stopping_;
+        });
+      }
+      if (!worker->queue.tryPop(task)) {
+        return;
+      }
+      {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        worker->space.notify_one();
+      }
+
+      StudentSnapshot::DecodedBatch batch =
+          StudentSnapshot::decodeBatch(std::move(task.message));
+      if (handler_) {
+        std::lock_guard<std::mutex> lock(handlerMutex_);
+        handler_(batch.views);
+      }
+      results_[task.index] = std::move(batch);
+
+      {
+        std::lock_guard<std::mutex> lock(doneMutex_);
+        decoded_++;
+      }
+      done_.notify_all();
+    }
+  }
+
+  // Ожидание разбора всех переданных пакетов
+  void wait() {
+    std::unique_lock<std::mutex> lock(doneMutex_);
+    done_.wait(lock, [this] { return decoded_ == pushed_; });
+  }
+
+  unsigned threadCount_;
+  RecordHandler handler_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::atomic<bool> stopping_{false};
+
+  // Результаты по порядку передачи: поток разбора пишет только в ячейку
+  // своего пакета, поток приема читает их после wait()
+  std::vector<StudentSnapshot::DecodedBatch> results_;
+  size_t pushed_ = 0;
+  size_t decoded_ = 0;  // под doneMutex_
+  std::mutex doneMutex_;
+  std::condition_variable done_;
+  std::mutex handlerMutex_;
+};
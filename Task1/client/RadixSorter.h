@@ -0,0 +1,223 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../common/Parallel.h"
+
+// Сортировка строк по ключам с числовым префиксом (MSD radix sort). Для
+// каждой строки один раз вычисляется префикс ключа (PREFIX_BYTES байт
+// одним числом), и дальше переставляются компактные пары «префикс,
+// номер строки»: префиксы раскладываются по корзинам байт за байтом,
+// начиная со старшего. Полное сравнение ключей нужно только строкам с
+// равными префиксами и маленьким корзинам. Сортировка устойчивая: строки
+// с равными ключами сохраняют исходный порядок.
+//
+// keyOf(row) возвращает ключ строки с методами prefix() (префикс, в котором
+// первый байт ключа — старший, недостающие байты — нули) и compare(other)
+// (полное сравнение: <0, 0, >0), например FullNameRef.
+//
+// Большие списки сортируются в нескольких потоках: каждый поток сортирует
+// свой отрезок, затем отрезки сливаются попарно. Каждое слияние делится
+// между потоками по диагоналям (merge path): поток находит бинарным поиском
+// начало своей части в обоих отрезках и сливает ее независимо. Строки с
+// равными ключами упорядочены по номеру строки, поэтому результат тот же,
+// что у сортировки в одном потоке
+class RadixSorter {
+ public:
+  static constexpr int PREFIX_BYTES = 8;
+
+  // Корзины меньше этого размера сортируются сравнением
+  static constexpr size_t SMALL_RANGE = 32;
+
+  // Меньшие списки сортируются в одном потоке: запуск потоков и слияние
+  // обходятся дороже выигрыша
+  static constexpr size_t PARALLEL_THRESHOLD = 1 << 16;
+
+  // Порядок строк 0..count-1 по возрастанию ключей. threadCount — потоков
+  // сортировки (0 — по числу ядер); keyOf вызывается из всех этих потоков
+  template <typename KeyOf>
+  static std::vector<uint32_t> order(size_t count, KeyOf keyOf,
+                                     unsigned threadCount = 1) {
+    if (threadCount == 0) {
+      threadCount = defaultThreadCount();
+    }
+    if (count < PARALLEL_THRESHOLD) {
+      threadCount = 1;
+    }
+
+    // Отрезки потоков: bounds[i], bounds[i + 1]
+    std::vector<size_t> bounds(threadCount + 1);
+    for (unsigned i = 0; i <= threadCount; ++i) {
+      bounds[i] = count * i / threadCount;
+    }
+
+    std::vector<Entry> entries(count);
+    std::vector<Entry> buffer(count);
+    parallelFor(threadCount, threadCount, [&](size_t run) {
+      for (size_t row = bounds[run]; row < bounds[run + 1]; ++row) {
+        entries[row] = Entry{keyOf(row).prefix(), static_cast<uint32_t>(row)};
+      }
+      sortRange(entries.data() + bounds[run], buffer.data() + bounds[run],
+                bounds[run + 1] - bounds[run], 0, keyOf);
+    });
+    mergeRuns(entries, buffer, std::move(bounds), threadCount, keyOf);
+
+    std::vector<uint32_t> rows(count);
+    for (size_t i = 0; i < count; ++i) {
+      rows[i] = entries[i].row;
+    }
+    return rows;
+  }
+
+ private:
+  struct Entry {
+    uint64_t prefix;
+    uint32_t row;
+  };
+
+  // Сортировка entries[0, count), у которых совпадают первые byte байт
+  // префикса; buffer — место для раскладки того же размера
+  template <typename KeyOf>
+  static void sortRange(Entry* entries, Entry* buffer, size_t count, int byte,
+                        KeyOf& keyOf) {
+    if (count < SMALL_RANGE || byte == PREFIX_BYTES) {
+      sortByKeys(entries, count, keyOf);
+      return;
+    }
+
+    const int shift = 8 * (PREFIX_BYTES - 1 - byte);
+    size_t counts[256] = {};
+    for (size_t i = 0; i < count; ++i) {
+      counts[(entries[i].prefix >> shift) & 0xFF]++;
+    }
+
+    // Общий байт у всех строк (например, одинаковое начало имени):
+    // раскладывать нечего
+    if (counts[(entries[0].prefix >> shift) & 0xFF] == count) {
+      sortRange(entries, buffer, count, byte + 1, keyOf);
+      return;
+    }
+
+    size_t offsets[256];
+    size_t offset = 0;
+    for (int digit = 0; digit < 256; ++digit) {
+      offsets[digit] = offset;
+      offset += counts[digit];
+    }
+    for (size_t i = 0; i < count; ++i) {
+      buffer[offsets[(entries[i].prefix >> shift) & 0xFF]++] = entries[i];
+    }
+    std::copy(buffer, buffer + count, entries);
+
+    size_t start = 0;
+    for (int digit = 0; digit < 256; ++digit) {
+      if (counts[digit] > 1) {
+        sortRange(entries + start, buffer + start, counts[digit], byte + 1,
+                  keyOf);
+      }
+      start += counts[digit];
+    }
+  }
+
+  // Сортировка сравнением
+  template <typename KeyOf>
+  static void sortByKeys(Entry* entries, size_t count, KeyOf& keyOf) {
+    std::sort(entries, entries + count, [&](const Entry& a, const Entry& b) {
+      return entryLess(a, b, keyOf);
+    });
+  }
+
+  // Префикс, затем полный ключ, затем номер строки (строки с равными
+  // ключами сохраняют исходный порядок)
+  template <typename KeyOf>
+  static bool entryLess(const Entry& a, const Entry& b, KeyOf& keyOf) {
+    if (a.prefix != b.prefix) {
+      return a.prefix < b.prefix;
+    }
+    int result = keyOf(a.row).compare(keyOf(b.row));
+    if (result != 0) {
+      return result < 0;
+    }
+    return a.row < b.row;
+  }
+
+  // Попарное слияние отсортированных отрезков entries (границы — bounds),
+  // пока не останется один. Слияние пары делится на части примерно
+  // поровну на всех потоках; buffer — место для результата
+  template <typename KeyOf>
+  static void mergeRuns(std::vector<Entry>& entries, std::vector<Entry>& buffer,
+                        std::vector<size_t> bounds, unsigned threadCount,
+                        KeyOf& keyOf) {
+    auto less = [&](const Entry& a, const Entry& b) {
+      return entryLess(a, b, keyOf);
+    };
+
+    // Часть слияния отрезков [begin, middle) и [middle, end): выходы с
+    // from по to (от begin)
+    struct Piece {
+      size_t begin, middle, end;
+      size_t from, to;
+    };
+
+    while (bounds.size() > 2) {
+      std::vector<size_t> merged;
+      std::vector<Piece> pieces;
+      for (size_t i = 0; i + 1 < bounds.size(); i += 2) {
+        size_t begin = bounds[i];
+        size_t middle = bounds[i + 1];
+        size_t end = i + 2 < bounds.size() ? bounds[i + 2] : middle;
+        size_t parts = std::max<size_t>(
+            1, threadCount * (end - begin) / entries.size());
+        for (size_t part = 0; part < parts; ++part) {
+          pieces.push_back(Piece{begin, middle, end,
+                                 (end - begin) * part / parts,
+                                 (end - begin) * (part + 1) / parts});
+        }
+        merged.push_back(begin);
+      }
+      merged.push_back(bounds.back());
+
+      parallelFor(pieces.size(), threadCount, [&](size_t i) {
+        const Piece& piece = pieces[i];
+        const Entry* first = entries.data() + piece.begin;
+        const Entry* second = entries.data() + piece.middle;
+        size_t firstSize = piece.middle - piece.begin;
+        size_t secondSize = piece.end - piece.middle;
+
+        size_t fromFirst =
+            mergeSplit(first, firstSize, second, secondSize, piece.from, less);
+        size_t toFirst =
+            mergeSplit(first, firstSize, second, secondSize, piece.to, less);
+        std::merge(first + fromFirst, first + toFirst,
+                   second + (piece.from - fromFirst),
+                   second + (piece.to - toFirst),
+                   buffer.data() + piece.begin + piece.from, less);
+      });
+
+      entries.swap(buffer);
+      bounds = std::move(merged);
+    }
+  }
+
+  // Сколько элементов first попадает в первые diagonal элементов слияния
+  // first и second (бинарный поиск по диагонали merge path)
+  template <typename Less>
+  static size_t mergeSplit(const Entry* first, size_t firstSize,
+                           const Entry* second, size_t secondSize,
+                           size_t diagonal, Less& less) {
+    size_t low = diagonal > secondSize ? diagonal - secondSize : 0;
+    size_t high = std::min(diagonal, firstSize);
+    while (low < high) {
+      size_t middle = low + (high - low) / 2;
+      if (less(first[middle], second[diagonal - middle - 1])) {
+        low = middle + 1;
+      } else {
+        high = middle;
+      }
+    }
+    return low;
+  }
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Ограниченная очередь без блокировок для одного производителя и одного
+// потребителя (кольцевой буфер). tryPush вызывает только поток
+// производителя, tryPop — только поток потребителя. Емкость округляется
+// вверх до степени двойки. Индексы чтения и записи лежат в разных линиях
+// кеша: производитель и потребитель не мешают друг другу
+template <typename T>
+class SpscQueue {
+ public:
+  explicit SpscQueue(size_t capacity) {
+    size_t size = 1;
+    while (size < capacity) {
+      size <<= 1;
+    }
+    slots_.resize(size);
+    mask_ = size - 1;
+  }
+
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  // Добавление в очередь; false — очередь заполнена (value не изменяется)
+  bool tryPush(T& value) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == slots_.size()) {
+      return false;
+    }
+    slots_[tail & mask_] = std::move(value);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Извлечение из очереди; false — очередь пуста
+  bool tryPop(T& value) {
+    size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    value = std::move(slots_[head & mask_]);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Заполнена ли очередь (точно — только в потоке производителя)
+  bool full() const {
+    return tail_.load(std::memory_order_relaxed) -
+               head_.load(std::memory_order_acquire) ==
+           slots_.size();
+  }
+
+  bool empty() const {
+    return head_.load(std::memory_order_acquire) ==
+           tail_.load(std::memory_order_acquire);
+  }
+
+  size_t capacity() const { return slots_.size(); }
+
+ private:
+  static constexpr size_t CACHE_LINE = 64;
+
+  std::vector<T> slots_;
+  size_t mask_ = 0;
+  alignas(CACHE_LINE) std::atomic<size_t> head_{0};  // следующий для чтения
+  alignas(CACHE_LINE) std::atomic<size_t> tail_{0};  // следующий для записи
+};
@@ -0,0 +1,284 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include <zmq.hpp>
+
+#include "../common/Collation.h"
+#include "../common/Protocol.h"
+#include "../common/Student.h"
+#include "Serializer.h"
+
+// Число записей, затронутых изменениями списка
+struct DeltaCounts {
+  size_t added = 0;
+  size_t updated = 0;
+  size_t removed = 0;
+};
+
+// Принятый список студентов без копирования данных. Снимок владеет
+// сообщениями ZeroMQ (одним или пакетами потоковой публикации), а записи —
+// StudentView, имена которых ссылаются прямо на байты сообщений. Порядок
+// записей можно менять (сортировка переставляет только представления),
+// сами байты не копируются.
+// Текстовый формат (старый сервер) разбирается в Student, и представления
+// ссылаются на них
+class StudentSnapshot {
+ public:
+  using const_iterator = std::vector<StudentView>::const_iterator;
+  using iterator = std::vector<StudentView>::iterator;
+
+  // Разобранный пакет, еще не добавленный в снимок: сообщение, записи и
+  // массив ID, на которые они ссылаются. Пакеты разбираются независимо
+  // (например, в разных потоках), а в снимок добавляются по порядку
+  struct DecodedBatch {
+    std::unique_ptr<zmq::message_t> message;
+    std::vector<StudentView> views;
+    std::vector<int> ids;
+  };
+
+  StudentSnapshot() = default;
+
+  // Разбор сообщения; сообщение переходит во владение снимка
+  static StudentSnapshot decode(zmq::message_t&& message,
+                                protocol::WireFormat format) {
+    StudentSnapshot snapshot;
+    if (format != protocol::WireFormat::Text) {
+      snapshot.appendBatch(std::move(message));
+      return snapshot;
+    }
+
+    std::string data(static_cast<const char*>(message.data()), message.size());
+    snapshot.students_ = Serializer::deserialize(data);
+    snapshot.views_.reserve(snapshot.students_.size());
+    for (const auto& student : snapshot.students_) {
+      StudentView view;
+      view.ids = student.ids.data();
+      view.idCount = student.ids.size();
+      view.firstName = student.firstName;
+      view.middleName = student.middleName;
+      view.lastName = student.lastName;
+      view.birthDate = student.birthDate;
+      snapshot.views_.push_back(view);
+    }
+    return snapshot;
+  }
+
+  // Добавление пакета в двоичном формате в конец снимка; возвращает число
+  // разобранных записей пакета
+  size_t appendBatch(zmq::message_t&& message) {
+    return appendDecoded(decodeBatch(std::move(message)));
+  }
+
+  // Разбор пакета в двоичном формате без снимка. Сообщение хранится в
+  // куче: маленькие сообщения ZeroMQ держит прямо в объекте message_t, а
+  // записи ссылаются на его байты, и перемещение пакета не должно их
+  // сдвигать
+  static DecodedBatch decodeBatch(zmq::message_t&& message) {
+    DecodedBatch batch;
+    batch.message = std::make_unique<zmq::message_t>(std::move(message));
+    Serializer::deserializeBinaryViews(batch.message->data(),
+                                       batch.message->size(), batch.views,
+                                       batch.ids);
+    return batch;
+  }
+
+  // Добавление разобранного пакета в конец снимка; возвращает число
+  // записей пакета
+  size_t appendDecoded(DecodedBatch&& batch) {
+    std::vector<StudentView> views = storeBatch(std::move(batch));
+    views_.insert(views_.end(), views.begin(), views.end());
+    collationKeys_.clear();
+    return views.size();
+  }
+
+  // Применение изменений списка (три блока в двоичном формате, см.
+  // protocol::DELTA_TOPIC). Записи ищутся по ключу объединения: измененные
+  // заменяются на месте, удаленные убираются, добавленные (и измененные,
+  // которых в снимке нет) добавляются в конец. Сообщения с новыми
+  // записями переходят во владение снимка; байты замененных и удаленных
+  // записей остаются в прежних сообщениях до нового снимка
+  DeltaCounts applyDelta(zmq::message_t&& added, zmq::message_t&& updated,
+                         const zmq::message_t& removed) {
+    DeltaCounts counts;
+    collationKeys_.clear();
+
+    // Ключи измененных и удаленных записей; записи снимка сначала
+    // отбираются по дате, ключ строится только при совпадении даты
+    struct Change {
+      const StudentView* value;  // nullptr — запись удалена
+      bool applied;
+    };
+    std::unordered_map<std::string, Change> changes;
+    std::unordered_set<uint32_t> dates;
+
+    std::vector<StudentView> updatedViews =
+        storeBatch(decodeBatch(std::move(updated)));
+    std::vector<StudentView> removedViews;
+    std::vector<int> removedIds;
+    Serializer::deserializeBinaryViews(removed.data(), removed.size(),
+                                       removedViews, removedIds);
+    for (const auto& view : removedViews) {
+      changes[keyOf(view)] = {nullptr, false};
+      dates.insert(view.birthDate.pack());
+    }
+    for (const auto& view : updatedViews) {
+      changes[keyOf(view)] = {&view, false};
+      dates.insert(view.birthDate.pack());
+    }
+
+    if (!changes.empty()) {
+      size_t kept = 0;
+      for (size_t i = 0; i < views_.size(); ++i) {
+        StudentView view = views_[i];
+        if (dates.count(view.birthDate.pack()) > 0) {
+          auto change = changes.find(keyOf(view));
+          if (change != changes.end() && !change->second.applied) {
+            change->second.applied = true;
+            if (change->second.value == nullptr) {
+              counts.removed++;
+              continue;
+            }
+            view = *change->second.value;
+            counts.updated++;
+          }
+        }
+        views_[kept++] = view;
+      }
+      views_.resize(kept);
+    }
+
+    for (const auto& view : updatedViews) {
+      if (!changes[keyOf(view)].applied) {
+        views_.push_back(view);
+        counts.added++;
+      }
+    }
+    std::vector<StudentView> addedViews =
+        storeBatch(decodeBatch(std::move(added)));
+    views_.insert(views_.end(), addedViews.begin(), addedViews.end());
+    counts.added += addedViews.size();
+    return counts;
+  }
+
+  // Оставляет записи, для которых keep возвращает true, в прежнем
+  // порядке; байты отброшенных записей остаются в сообщениях
+  template <typename Predicate>
+  void retain(Predicate keep) {
+    collationKeys_.clear();
+    views_.erase(std::remove_if(views_.begin(), views_.end(),
+                                [&](const StudentView& view) {
+                                  return !keep(view);
+                                }),
+                 views_.end());
+  }
+
+  void clear() {
+    messages_.clear();
+    students_.clear();
+    idBlocks_.clear();
+    views_.clear();
+    collationKeys_.clear();
+  }
+
+  // Перестановка записей: запись i — бывшая запись order[i]. Ключи
+  // сопоставления переставляются вместе с записями
+  void reorder(const std::vector<uint32_t>& order) {
+    std::vector<StudentView> views;
+    views.reserve(order.size());
+    for (uint32_t row : order) {
+      views.push_back(views_[row]);
+    }
+    views_ = std::move(views);
+    if (!collationKeys_.empty()) {
+      collationKeys_.reorder(order);
+    }
+  }
+
+  // Ключи сопоставления ФИО (RussianCollation) в порядке записей. Строятся
+  // при первом вызове и хранятся в снимке до его изменения: повторная
+  // сортировка их не перестраивает
+  const CollationKeys& collationKeys() {
+    if (collationKeys_.size() != views_.size()) {
+      collationKeys_.build(views_.size(), [&](size_t row) {
+        return views_[row].fullNameRef();
+      });
+    }
+    return collationKeys_;
+  }
+
+  size_t size() const { return views_.size(); }
+  bool empty() const { return views_.empty(); }
+
+  const StudentView& operator[](size_t i) const { return views_[i]; }
+  const std::vector<StudentView>& views() const { return views_; }
+
+  const_iterator begin() const { return views_.begin(); }
+  const_iterator end() const { return views_.end(); }
+  // Записи можно менять через итераторы, поэтому ключи сопоставления
+  // сбрасываются
+  iterator begin() {
+    collationKeys_.clear();
+    return views_.begin();
+  }
+  iterator end() { return views_.end(); }
+
+  // Размер сообщений, которыми владеет снимок (текст разбирается в Student,
+  // и сообщение не хранится)
+  size_t payloadBytes() const {
+    size_t bytes = 0;
+    for (const auto& message : messages_) {
+      bytes += message->size();
+    }
+    return bytes;
+  }
+
+  size_t batchCount() const { return messages_.size(); }
+
+  // Копирование записей в самостоятельные объекты Student
+  std::vector<Student> toStudents() const {
+    std::vector<Student> students;
+    students.reserve(views_.size());
+    for (const auto& view : views_) {
+      students.push_back(view.materialize());
+    }
+    return students;
+  }
+
+ private:
+  // Сохранение разобранного пакета: сообщение и массив ID переходят в
+  // снимок, представления возвращаются (в views_ не добавляются). У
+  // каждого пакета свой массив ID: при добавлении пакетов массивы
+  // перемещаются, но их данные, на которые ссылаются views_, остаются на
+  // месте
+  std::vector<StudentView> storeBatch(DecodedBatch&& batch) {
+    messages_.push_back(std::move(batch.message));
+    idBlocks_.push_back(std::move(batch.ids));
+    return std::move(batch.views);
+  }
+
+  // Ключ объединения записи: ФИО и упакованная дата
+  static std::string keyOf(const StudentView& view) {
+    uint32_t date = view.birthDate.pack();
+    std::string key;
+    key.reserve(view.firstName.size() + view.middleName.size() +
+                view.lastName.size() + 2 + sizeof(date));
+    key.append(view.firstName).append(1, '\n');
+    key.append(view.middleName).append(1, '\n');
+    key.append(view.lastName);
+    key.append(reinterpret_cast<const char*>(&date), sizeof(date));
+    return key;
+  }
+
+  std::vector<std::unique_ptr<zmq::message_t>> messages_;
+  std::vector<Student> students_;
+  std::vector<std::vector<int>> idBlocks_;
+  std::vector<StudentView> views_;
+  CollationKeys collationKeys_;
+};
\ No newline at end of file
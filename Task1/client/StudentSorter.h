@@ -1,55 +1,325 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 #include <iomanip>
 #include <iostream>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
+#include "Collation.h"
+#include "RadixSorter.h"
 #include "Student.h"
+#include "StudentSnapshot.h"
+#include "StudentTable.h"
 
 class StudentSorter {
  public:
-  // Сортировка студентов по ФИО
-  static void sortByFullName(std::vector<Student>& students) {
+  // Сортировка студентов по ФИО. Ключи сортировки (префикс ФИО и номер
+  // строки) строятся один раз, строки ФИО не создаются (RadixSorter).
+  // Порядок — как у сравнения строк getFullName(); равные ФИО сохраняют
+  // исходный порядок. threadCount — потоков сортировки (0 — по числу ядер);
+  // небольшие списки сортируются в одном потоке. NameOrder::Russian —
+  // порядок русского алфавита: ключи RussianCollation строятся один раз
+  // на запись и сравниваются memcmp
+  static void sortByFullName(std::vector<Student>& students,
+                             unsigned threadCount = 0,
+                             NameOrder nameOrder = NameOrder::Bytes) {
     std::cout << "\n🔤 Сортировка студентов по ФИО..." << std::endl;
 
-    std::sort(students.begin(), students.end(),
-              [](const Student& a, const Student& b) {
-                return a.getFullName() < b.getFullName();
-              });
+    std::vector<uint32_t> order;
+    if (nameOrder == NameOrder::Russian) {
+      CollationKeys keys;
+      keys.build(students.size(),
+                 [&](size_t row) { return students[row].fullNameRef(); });
+      order = RadixSorter::order(
+          keys.size(), [&](size_t row) { return keys[row]; }, threadCount);
+    } else {
+      order = RadixSorter::order(
+          students.size(),
+          [&](size_t row) { return students[row].fullNameRef(); },
+          threadCount);
+    }
+
+    std::vector<Student> sorted;
+    sorted.reserve(students.size());
+    for (uint32_t row : order) {
+      sorted.push_back(std::move(students[row]));
+    }
+    students = std::move(sorted);
+
+    std::cout << "✅ Сортировка завершена" << std::endl;
+  }
+
+  // Сортировка таблицы по ФИО. Каждое имя пула сравнивается со строками
+  // только один раз — при вычислении его ранга, дальше строки таблицы
+  // сравниваются тройками рангов. Для имен из букв это тот же порядок, что
+  // у getFullName (пробел меньше любой буквы); равные ФИО сохраняют
+  // исходный порядок
+  static void sortByFullName(StudentTable& students) {
+    std::cout << "\n🔤 Сортировка студентов по ФИО..." << std::endl;
+
+    const StringPool& pool = students.pool();
+    std::vector<uint32_t> byName(pool.size());
+    std::iota(byName.begin(), byName.end(), 0);
+    std::sort(byName.begin(), byName.end(), [&](uint32_t a, uint32_t b) {
+      return pool.get(a) < pool.get(b);
+    });
+    std::vector<uint32_t> ranks(pool.size());
+    for (size_t i = 0; i < byName.size(); ++i) {
+      ranks[byName[i]] = static_cast<uint32_t>(i);
+    }
+
+    std::vector<uint32_t> order(students.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+      uint32_t firstA = ranks[students.firstNameId(a)];
+      uint32_t firstB = ranks[students.firstNameId(b)];
+      if (firstA != firstB) return firstA < firstB;
+      uint32_t middleA = ranks[students.middleNameId(a)];
+      uint32_t middleB = ranks[students.middleNameId(b)];
+      if (middleA != middleB) return middleA < middleB;
+      return ranks[students.lastNameId(a)] < ranks[students.lastNameId(b)];
+    });
+
+    students = students.reordered(order);
 
     std::cout << "✅ Сортировка завершена" << std::endl;
   }
 
   // Вывод списка студентов на экран
   static void displayStudents(const std::vector<Student>& students) {
+    printHeader(students.size());
+    for (const auto& student : students) {
+      printRow(student.ids.data(), student.ids.size(), student.getFullName(),
+               student.birthDate);
+    }
+    printFooter();
+  }
+
+  // Вывод таблицы студентов на экран (формат как у списка Student)
+  static void displayStudents(const StudentTable& students) {
+    printHeader(students.size());
+    for (size_t row = 0; row < students.size(); ++row) {
+      StudentTable::IdRange ids = students.ids(row);
+      printRow(ids.begin(), ids.size(), students.fullName(row),
+               students.birthDate(row));
+    }
+    printFooter();
+  }
+
+  // Сортировка принятого снимка по ФИО: переставляются только
+  // представления, байты сообщения не копируются. Порядок — как у
+  // сортировки списка Student; равные ФИО сохраняют порядок приема. Ключи
+  // NameOrder::Russian хранятся в снимке и при повторной сортировке не
+  // строятся заново
+  static void sortByFullName(StudentSnapshot& students,
+                             unsigned threadCount = 0,
+                             NameOrder nameOrder = NameOrder::Bytes) {
+    std::cout << "\n🔤 Сортировка студентов по ФИО..." << std::endl;
+
+    std::vector<uint32_t> order;
+    if (nameOrder == NameOrder::Russian) {
+      const CollationKeys& keys = students.collationKeys();
+      order = RadixSorter::order(
+          keys.size(), [&](size_t row) { return keys[row]; }, threadCount);
+    } else {
+      const std::vector<StudentView>& views = students.views();
+      order = RadixSorter::order(
+          views.size(), [&](size_t row) { return views[row].fullNameRef(); },
+          threadCount);
+    }
+    students.reorder(order);
+
+    std::cout << "✅ Сортировка завершена" << std::endl;
+  }
+
+  static void displayStudents(const StudentSnapshot& students) {
+    displayStudents(students.begin(), students.end());
+  }
+
+  // Вывод записей [first, last) (например, результата firstByFullName или
+  // rangeByFullName)
+  static void displayStudents(StudentSnapshot::const_iterator first,
+                              StudentSnapshot::const_iterator last) {
+    printHeader(static_cast<size_t>(last - first));
+    for (auto it = first; it != last; ++it) {
+      printRow(it->ids, it->idCount, it->getFullName(), it->birthDate);
+    }
+    printFooter();
+  }
+
+  // Вывод по страницам из pageSize записей: после каждой страницы, кроме
+  // последней, ждет строку из input (пустая — следующая страница, "q" —
+  // конец вывода). Строки выводятся сразу, без сборки всего списка
+  static void displayPaged(StudentSnapshot::const_iterator first,
+                           StudentSnapshot::const_iterator last,
+                           size_t pageSize, std::istream& input) {
+    size_t total = static_cast<size_t>(last - first);
+    printHeader(total);
+    if (pageSize == 0) {
+      pageSize = total;
+    }
+
+    size_t shown = 0;
+    for (auto it = first; it != last; ++it) {
+      printRow(it->ids, it->idCount, it->getFullName(), it->birthDate);
+      shown++;
+      if (shown % pageSize == 0 && shown < total) {
+        std::cout << "-- " << shown << " из " << total
+                  << " (Enter — дальше, q — выход) --" << std::endl;
+        std::string answer;
+        if (!std::getline(input, answer) || answer == "q") {
+          break;
+        }
+      }
+    }
+    printFooter();
+  }
+
+  // Первые count записей в порядке sortByFullName без сортировки всего
+  // снимка: выбор через кучу из count записей, O(n log count). Снимок не
+  // меняется (кроме ключей NameOrder::Russian, которые строятся и
+  // сохраняются в нем)
+  static std::vector<StudentView> firstByFullName(
+      StudentSnapshot& students, size_t count,
+      NameOrder nameOrder = NameOrder::Bytes) {
+    return sliceByFullName(students, 0, count, nameOrder);
+  }
+
+  // Записи с номерами [from, to) в порядке sortByFullName (страница
+  // списка), O(n log to). У уже отсортированного снимка страница — просто
+  // отрезок views()
+  static std::vector<StudentView> sliceByFullName(
+      StudentSnapshot& students, size_t from, size_t to,
+      NameOrder nameOrder = NameOrder::Bytes) {
+    std::vector<uint32_t> rows;
+    if (nameOrder == NameOrder::Russian) {
+      const CollationKeys& keys = students.collationKeys();
+      rows = firstRows(keys.size(), to, [&](uint32_t a, uint32_t b) {
+        int result = keys[a].compare(keys[b]);
+        return result != 0 ? result < 0 : a < b;
+      });
+    } else {
+      const std::vector<StudentView>& views = students.views();
+      rows = firstRows(views.size(), to, [&](uint32_t a, uint32_t b) {
+        int result = views[a].fullNameRef().compare(views[b].fullNameRef());
+        return result != 0 ? result < 0 : a < b;
+      });
+    }
+
+    std::vector<StudentView> slice;
+    for (size_t i = from; i < rows.size(); ++i) {
+      slice.push_back(students[rows[i]]);
+    }
+    return slice;
+  }
+
+  // Записи отсортированного снимка (sortByFullName, NameOrder::Bytes), у
+  // которых строка ФИО в [from, to): двоичный поиск, O(log n). Например,
+  // ("Иван", "Ивао") — все студенты с именем, начинающимся на "Иван"
+  static std::pair<StudentSnapshot::const_iterator,
+                   StudentSnapshot::const_iterator>
+  rangeByFullName(const StudentSnapshot& sorted, std::string_view from,
+                  std::string_view to) {
+    auto first = std::lower_bound(
+        sorted.begin(), sorted.end(), from,
+        [](const StudentView& view, std::string_view bound) {
+          return view.fullNameRef().compare(bound) < 0;
+        });
+    auto last = std::lower_bound(
+        first, sorted.end(), to,
+        [](const StudentView& view, std::string_view bound) {
+          return view.fullNameRef().compare(bound) < 0;
+        });
+    return {first, last};
+  }
+
+  // Записи, фамилия которых в [from, to) (сравнение байтов), в порядке
+  // sortByFullName. Снимок отсортирован по имени, а не по фамилии, поэтому
+  // записи отбираются просмотром, O(n), и сортируются только найденные
+  static std::vector<StudentView> rangeByLastName(
+      const StudentSnapshot& students, std::string_view from,
+      std::string_view to) {
+    std::vector<StudentView> found;
+    for (const auto& view : students) {
+      if (view.lastName >= from && view.lastName < to) {
+        found.push_back(view);
+      }
+    }
+
+    std::vector<uint32_t> order = RadixSorter::order(
+        found.size(), [&](size_t row) { return found[row].fullNameRef(); });
+    std::vector<StudentView> sorted;
+    sorted.reserve(found.size());
+    for (uint32_t row : order) {
+      sorted.push_back(found[row]);
+    }
+    return sorted;
+  }
+
+ private:
+  // Номера первых count строк из 0..total-1 в порядке less: куча из count
+  // наибольших среди отобранных, вершина — кандидат на вытеснение
+  template <typename Less>
+  static std::vector<uint32_t> firstRows(size_t total, size_t count,
+                                         Less less) {
+    count = std::min(count, total);
+    std::vector<uint32_t> heap;
+    heap.reserve(count);
+    if (count == 0) {
+      return heap;
+    }
+
+    for (size_t i = 0; i < total; ++i) {
+      uint32_t row = static_cast<uint32_t>(i);
+      if (heap.size() < count) {
+        heap.push_back(row);
+        std::push_heap(heap.begin(), heap.end(), less);
+      } else if (less(row, heap.front())) {
+        std::pop_heap(heap.begin(), heap.end(), less);
+        heap.back() = row;
+        std::push_heap(heap.begin(), heap.end(), less);
+      }
+    }
+    std::sort_heap(heap.begin(), heap.end(), less);
+    return heap;
+  }
+
+  static void printHeader(size_t count) {
     std::cout << "\n" << std::string(70, '=') << std::endl;
-    std::cout << "📋 СПИСОК СТУДЕНТОВ (" << students.size() << ")" << std::endl;
+    std::cout << "📋 СПИСОК СТУДЕНТОВ (" << count << ")" << std::endl;
     std::cout << std::string(70, '=') << std::endl;
 
-    if (students.empty()) {
+    if (count == 0) {
       std::cout << "Список пуст" << std::endl;
     } else {
       std::cout << std::left;
       std::cout << std::setw(15) << "ID" << std::setw(35) << "ФИО"
                 << "Дата рождения" << std::endl;
       std::cout << std::string(70, '-') << std::endl;
+    }
+  }
 
-      for (const auto& student : students) {
-        // Форматируем ID
-        std::string idsStr;
-        for (size_t i = 0; i < student.ids.size(); ++i) {
-          idsStr += std::to_string(student.ids[i]);
-          if (i < student.ids.size() - 1) {
-            idsStr += ", ";
-          }
-        }
-
-        std::cout << std::setw(15) << idsStr << std::setw(35)
-                  << student.getFullName() << student.birthDate.toString()
-                  << std::endl;
+  static void printRow(const int* ids, size_t idCount,
+                       const std::string& fullName, const Date& birthDate) {
+    // Форматируем ID
+    std::string idsStr;
+    for (size_t i = 0; i < idCount; ++i) {
+      idsStr += std::to_string(ids[i]);
+      if (i < idCount - 1) {
+        idsStr += ", ";
       }
     }
 
+    std::cout << std::setw(15) << idsStr << std::setw(35) << fullName
+              << birthDate.toString() << std::endl;
+  }
+
+  static void printFooter() {
     std::cout << std::string(70, '=') << std::endl;
   }
 };
\ No newline at end of file
@@ -1,20 +1,51 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
 #include <iostream>
+#include <map>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <string_view>
 #include <thread>
+#include <vector>
 #include <zmq.hpp>
 
+#include "../common/Protocol.h"
+#include "../common/SharedMemory.h"
 #include "../common/Student.h"
+#include "BatchDecoder.h"
 #include "Serializer.h"
+#include "StudentSnapshot.h"
 
 class ZmqSyncedSubscriber {
  public:
-  ZmqSyncedSubscriber(const std::string& subEndpoint,
-                      const std::string& syncEndpoint)
+  // Обработчик примененных изменений: номер публикации после них и число
+  // затронутых записей. Вызывается из потока подписки
+  using UpdateHandler =
+      std::function<void(uint32_t publicationId, const DeltaCounts& counts)>;
+  // Обработчик записей по мере приема (см. setRecordHandler)
+  using RecordHandler = BatchDecoder::RecordHandler;
+
+  // preferredFormat — формат, который клиент запрашивает при синхронизации.
+  // Если сервер не поддерживает пакеты (или общую память), данные придут
+  // двоичным форматом целиком, если не поддерживает двоичный формат —
+  // текстом. Общую память (Shared) запрашивает только клиент на одной
+  // машине с сервером
+  ZmqSyncedSubscriber(
+      const std::string& subEndpoint, const std::string& syncEndpoint,
+      protocol::WireFormat preferredFormat = protocol::WireFormat::Stream)
       : subEndpoint_(subEndpoint),
         syncEndpoint_(syncEndpoint),
+        preferredFormat_(preferredFormat),
         running_(false),
         dataReceived_(false) {}
 
@@ -27,142 +58,933 @@ class ZmqSyncedSubscriber {
       return;
     }
 
+    // Поток предыдущей подписки мог завершиться сам
+    if (subscribeThread_.joinable()) {
+      subscribeThread_.join();
+    }
+
     running_ = true;
     dataReceived_ = false;
+    publicationId_ = 0;
     subscribeThread_ = std::thread(&ZmqSyncedSubscriber::subscribeLoop, this);
 
     std::cout << "📡 Synced Subscriber запущен" << std::endl;
   }
 
-  // Остановка подписки
+  // Остановка подписки. Поток присоединяется и тогда, когда подписка уже
+  // завершилась сама
   void stop() {
-    if (!running_) return;
-
-    running_ = false;
+    bool wasRunning = running_.exchange(false);
     if (subscribeThread_.joinable()) {
       subscribeThread_.join();
     }
 
-    std::cout << "📡 Synced Subscriber остановлен" << std::endl;
+    if (wasRunning) {
+      std::cout << "📡 Synced Subscriber остановлен" << std::endl;
+    }
   }
 
-  // Получение принятых данных
+  // Ожидание данных не дольше timeout без опроса: true — список принят,
+  // false — истек timeout или подписка завершилась без данных
+  bool waitForData(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(readyMutex_);
+    readyChanged_.wait_for(lock, timeout,
+                           [this] { return dataReceived_ || !running_; });
+    return dataReceived_;
+  }
+
+  // Получение принятых данных (копия в виде Student)
   std::vector<Student> getReceivedData() {
     std::lock_guard<std::mutex> lock(dataMutex_);
-    return receivedStudents_;
+    return snapshot_.toStudents();
+  }
+
+  // Принятые данные без копирования: снимок вместе с сообщением ZeroMQ
+  // передается вызывающему, у подписчика остается пустой снимок. В режиме
+  // изменений снимок забирается после stop()
+  StudentSnapshot takeSnapshot() {
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    return std::move(snapshot_);
+  }
+
+  // Канал восстановления потока (DEALER): пропущенные пакеты запрашиваются
+  // у publisher, прием подтверждается. Задается до start()
+  void setRepairEndpoint(const std::string& repairEndpoint) {
+    repairEndpoint_ = repairEndpoint;
+  }
+
+  // Сервис снимков publisher. Если синхронизация не удалась (публикация
+  // уже идет или завершилась) или точка синхронизации не задана, весь
+  // список запрашивается снимком. Задается до start()
+  void setSnapshotEndpoint(const std::string& snapshotEndpoint) {
+    snapshotEndpoint_ = snapshotEndpoint;
+  }
+
+  // Сколько ждать ответа на сигнал готовности; 0 — без ограничения (пока
+  // подписчик не остановлен). Задается до start()
+  void setSyncTimeout(std::chrono::milliseconds syncTimeout) {
+    syncTimeout_ = syncTimeout;
+  }
+
+  // Сколько ждать данных без единого сообщения после синхронизации
+  void setDataTimeout(std::chrono::milliseconds dataTimeout) {
+    dataTimeout_ = dataTimeout;
+  }
+
+  // Режим изменений: получив список, подписчик не завершается, а
+  // применяет к нему изменения из топика DELTA_TOPIC, пока не остановлен.
+  // Пропустив изменения (номер публикации не совпал), подписчик
+  // запрашивает снимок. Задается до start()
+  void setLiveUpdates(bool liveUpdates) { liveUpdates_ = liveUpdates; }
+
+  void setUpdateHandler(UpdateHandler handler) {
+    updateHandler_ = std::move(handler);
+  }
+
+  // Подписка только на шарды shards по схеме scheme (см.
+  // ZmqSyncedPublisher::setSharding): запрашиваются пакеты по шардам, и
+  // пакеты остальных шардов отбрасываются ZeroMQ до отправки. Если
+  // publisher шардов не знает или разбивает список по другой схеме, список
+  // принимается целиком и лишние записи отбрасываются подписчиком (так же —
+  // снимки и изменения). Задается до start()
+  void setShards(const protocol::ShardScheme& scheme,
+                 std::vector<std::string> shards) {
+    shardScheme_ = scheme;
+    shards_ = std::move(shards);
+    shardTopics_.clear();
+    for (const auto& shard : shards_) {
+      shardTopics_.push_back(protocol::shardTopic(shard));
+    }
+    if (shardScheme_.enabled()) {
+      preferredFormat_ = protocol::WireFormat::Sharded;
+    }
+  }
+
+  // Потоков разбора пакетов; 0 — по числу ядер. Поток подписки только
+  // принимает сообщения и передает пакеты на разбор, не дожидаясь его.
+  // Задается до start()
+  void setDecodeThreads(unsigned decodeThreads) {
+    decodeThreads_ = decodeThreads;
+  }
+
+  // Обработчик записей по мере приема, до сборки всего списка: для потока
+  // — каждый разобранный пакет (из потоков разбора, вызовы не
+  // пересекаются, порядок пакетов не гарантирован), для списка целиком и
+  // снимка — все записи сразу. Записи действительны только во время
+  // вызова. Задается до start()
+  void setRecordHandler(RecordHandler handler) {
+    recordHandler_ = std::move(handler);
+  }
+
+  // Общий контекст ZeroMQ: для адресов inproc:// подписчик и publisher
+  // должны работать в одном процессе с одним контекстом (см.
+  // ZmqSyncedPublisher::setContext). Задается до start()
+  void setContext(std::shared_ptr<zmq::context_t> context) {
+    context_ = std::move(context);
   }
 
+  // Номер публикации принятого списка; 0 — неизвестен (список пришел
+  // целиком без номера)
+  uint32_t publicationId() const { return publicationId_; }
+
   bool isDataReceived() const { return dataReceived_; }
   bool isRunning() const { return running_; }
 
  private:
   void subscribeLoop() {
     try {
-      zmq::context_t context(1);
+      std::shared_ptr<zmq::context_t> ownedContext =
+          context_ != nullptr ? context_
+                              : std::make_shared<zmq::context_t>(1);
+      zmq::context_t& context = *ownedContext;
 
       // SUB сокет для получения данных
       zmq::socket_t subscriber(context, zmq::socket_type::sub);
       subscriber.connect(subEndpoint_);
-      subscriber.set(zmq::sockopt::subscribe, "students");
+      // До ответа сервера формат неизвестен: подписываемся на все топики,
+      // которые могут прийти, лишние снимаем после синхронизации
+      for (protocol::WireFormat format : candidateFormats()) {
+        subscribe(subscriber, format, true);
+      }
+      // Изменения принимаются с самого начала: изменения, вышедшие, пока
+      // принимается список, не теряются
+      if (liveUpdates_) {
+        subscriber.set(zmq::sockopt::subscribe, protocol::DELTA_TOPIC);
+      }
 
-      // REQ сокет для синхронизации с publisher
-      zmq::socket_t syncClient(context, zmq::socket_type::req);
-      syncClient.connect(syncEndpoint_);
+      // DEALER сокет канала восстановления потока. Неотправленные запросы
+      // (сервер без канала) не задерживают завершение дольше LINGER
+      zmq::socket_t repairClient(context, zmq::socket_type::dealer);
+      repairClient.set(zmq::sockopt::linger,
+                       static_cast<int>(LINGER.count()));
 
       std::cout << "📡 Подключение к серверу:" << std::endl;
       std::cout << "   SUB: " << subEndpoint_ << std::endl;
-      std::cout << "   SYNC: " << syncEndpoint_ << std::endl;
+      if (!syncEndpoint_.empty()) {
+        std::cout << "   SYNC: " << syncEndpoint_ << std::endl;
+      }
+      if (!snapshotEndpoint_.empty()) {
+        std::cout << "   SNAPSHOT: " << snapshotEndpoint_ << std::endl;
+      }
+
+      // Без синхронизации данные по SUB не придут: список берем снимком
+      protocol::WireFormat format;
+      protocol::ShardManifest manifest;
+      if (syncEndpoint_.empty() || !synchronize(context, format, manifest)) {
+        if (running_ && !snapshotEndpoint_.empty()) {
+          receiveSnapshot(context);
+        } else if (running_) {
+          std::cerr << "❌ Не получено подтверждение от сервера" << std::endl;
+        }
+        if (liveUpdates_ && dataReceived_) {
+          followUpdates(context, subscriber);
+        }
+        finishLoop();
+        return;
+      }
+
+      for (protocol::WireFormat candidate : candidateFormats()) {
+        if (candidate != format) {
+          subscribe(subscriber, candidate, false);
+        }
+      }
+
+      std::cout << "✅ Получено подтверждение, готов к приему данных (формат: "
+                << protocol::formatName(format) << ")" << std::endl;
+
+      StreamState stream(decodeThreads_);
+      stream.decoder.setRecordHandler(recordHandler_);
+      bool unavailable = false;
+      if (format == protocol::WireFormat::Sharded) {
+        selectShards(subscriber, manifest, stream);
+      }
+
+      std::cout << "⏳ Ожидание данных..." << std::endl;
+
+      // Канал восстановления нужен только потоку
+      bool reliable = (format == protocol::WireFormat::Stream ||
+                       format == protocol::WireFormat::Sharded) &&
+                      !repairEndpoint_.empty();
+      if (reliable) {
+        repairClient.connect(repairEndpoint_);
+      }
+
+      // Ни одного запрошенного шарда в публикации нет
+      if (stream.selected && stream.wanted.empty()) {
+        finishStream(stream);
+      }
+      auto lastMessage = std::chrono::steady_clock::now();
+
+      while (running_ && !dataReceived_ &&
+             std::chrono::steady_clock::now() - lastMessage < dataTimeout_) {
+        zmq::pollitem_t items[] = {{subscriber.handle(), 0, ZMQ_POLLIN, 0},
+                                   {repairClient.handle(), 0, ZMQ_POLLIN, 0}};
+        zmq::poll(items, reliable ? 2 : 1, POLL_INTERVAL);
+
+        if (items[0].revents & ZMQ_POLLIN) {
+          lastMessage = std::chrono::steady_clock::now();
+          if (!receiveData(subscriber, stream)) {
+            unavailable = true;
+            break;
+          }
+        }
+        if (reliable && (items[1].revents & ZMQ_POLLIN)) {
+          lastMessage = std::chrono::steady_clock::now();
+          receiveRepair(repairClient, stream);
+        }
+        if (reliable && !dataReceived_) {
+          requestRepairs(repairClient, stream);
+        }
+      }
+
+      // Сегмент общей памяти недоступен (например, сервер на другой
+      // машине): список берем снимком
+      if (unavailable && running_ && !snapshotEndpoint_.empty()) {
+        receiveSnapshot(context);
+      }
+
+      if (!dataReceived_) {
+        std::cerr << "⚠️  Данные не получены за отведенное время" << std::endl;
+      } else if (reliable) {
+        // Подтверждаем прием, publisher перестает ждать этого подписчика
+        std::string done = protocol::doneMessage(stream.streamId);
+        zmq::message_t doneMsg(done.data(), done.size());
+        repairClient.send(doneMsg, zmq::send_flags::none);
+      }
+
+      if (liveUpdates_ && dataReceived_) {
+        followUpdates(context, subscriber);
+      }
+
+    } catch (const zmq::error_t& e) {
+      std::cerr << "❌ ZMQ Synced Subscriber ошибка: " << e.what() << std::endl;
+    }
+
+    finishLoop();
+  }
+
+  // Завершение потока подписки: ожидающие данных больше не ждут
+  void finishLoop() {
+    running_ = false;
+    notifyReady();
+  }
+
+  // Список принят
+  void setReceived() {
+    dataReceived_ = true;
+    notifyReady();
+  }
+
+  // Пробуждение waitForData. Мьютекс захватывается после изменения
+  // флагов: ожидающий либо уже видит их, либо ждет и получит уведомление
+  void notifyReady() {
+    {
+      std::lock_guard<std::mutex> lock(readyMutex_);
+    }
+    readyChanged_.notify_all();
+  }
+
+  // Записи, принятые целиком (список или снимок), — обработчику записей
+  void deliverRecords(const StudentSnapshot& snapshot) {
+    if (recordHandler_) {
+      recordHandler_(snapshot.views());
+    }
+  }
+
+  // Сигнал готовности publisher'у и ответ с форматом данных (для шардов —
+  // и с составом публикации). REQ сокет без сервера не задерживает
+  // завершение дольше LINGER. false — ответа нет за syncTimeout_ или
+  // подписчик остановлен
+  bool synchronize(zmq::context_t& context, protocol::WireFormat& format,
+                   protocol::ShardManifest& manifest) {
+    zmq::socket_t syncClient(context, zmq::socket_type::req);
+    syncClient.set(zmq::sockopt::linger, static_cast<int>(LINGER.count()));
+    syncClient.connect(syncEndpoint_);
+
+    // Отправляем сигнал готовности publisher'у
+    std::cout << "📤 Отправка сигнала готовности..." << std::endl;
+    std::string ready = protocol::readyMessage(preferredFormat_);
+    zmq::message_t syncMsg(ready.size());
+    memcpy(syncMsg.data(), ready.data(), ready.size());
+    syncClient.send(syncMsg, zmq::send_flags::none);
+
+    // Ждем подтверждения (не дольше syncTimeout_ и пока подписчик не
+    // остановлен)
+    zmq::message_t reply;
+    if (!awaitReply(syncClient, reply, syncTimeout_)) {
+      return false;
+    }
+    format = protocol::parseFormat(std::string_view(
+        static_cast<const char*>(reply.data()), reply.size()));
+
+    zmq::message_t manifestMessage;
+    if (reply.more() &&
+        syncClient.recv(manifestMessage, zmq::recv_flags::none)) {
+      skipMessage(syncClient, manifestMessage);
+    }
+    if (format == protocol::WireFormat::Sharded &&
+        !protocol::ShardManifest::decode(
+            std::string_view(static_cast<const char*>(manifestMessage.data()),
+                             manifestMessage.size()),
+            manifest)) {
+      std::cerr << "⚠️  Поврежден состав шардовой публикации" << std::endl;
+      return false;
+    }
+    return true;
+  }
 
-      // Отправляем сигнал готовности publisher'у
-      std::cout << "📤 Отправка сигнала готовности..." << std::endl;
-      zmq::message_t syncMsg(5);
-      memcpy(syncMsg.data(), "READY", 5);
-      syncClient.send(syncMsg, zmq::send_flags::none);
+  // Запрос всего списка у сервиса снимков: ответ — формат, номер
+  // публикации и данные; сообщение с данными переходит в снимок без
+  // копирования
+  void receiveSnapshot(zmq::context_t& context) {
+    zmq::socket_t snapshotClient(context, zmq::socket_type::req);
+    snapshotClient.set(zmq::sockopt::linger,
+                       static_cast<int>(LINGER.count()));
+    snapshotClient.connect(snapshotEndpoint_);
+
+    std::cout << "📸 Запрос снимка данных..." << std::endl;
+    std::string request =
+        protocol::snapshotRequest(preferredFormat_, shardScheme_, shards_);
+    zmq::message_t requestMsg(request.data(), request.size());
+    snapshotClient.send(requestMsg, zmq::send_flags::none);
+
+    zmq::message_t reply;
+    zmq::message_t publication;
+    zmq::message_t message;
+    if (!awaitReply(snapshotClient, reply, dataTimeout_) || !reply.more() ||
+        !snapshotClient.recv(publication, zmq::recv_flags::none) ||
+        !publication.more() ||
+        !snapshotClient.recv(message, zmq::recv_flags::none)) {
+      if (running_) {
+        std::cerr << "❌ Снимок не получен" << std::endl;
+      }
+      return;
+    }
 
-      // Ждем подтверждения
-      zmq::message_t reply;
-      auto result = syncClient.recv(reply, zmq::recv_flags::none);
+    protocol::WireFormat format = protocol::parseFormat(std::string_view(
+        static_cast<const char*>(reply.data()), reply.size()));
+    std::cout << "📥 Снимок публикации #"
+              << std::string_view(static_cast<const char*>(publication.data()),
+                                  publication.size())
+              << " получен (" << message.size() << " байт, формат: "
+              << protocol::formatName(format) << ")" << std::endl;
+
+    StudentSnapshot snapshot = StudentSnapshot::decode(std::move(message),
+                                                       format);
+    std::cout << "✅ Десериализовано " << snapshot.size() << " студентов"
+              << std::endl;
+    retainShards(snapshot);
+    deliverRecords(snapshot);
+
+    {
+      std::lock_guard<std::mutex> lock(dataMutex_);
+      snapshot_ = std::move(snapshot);
+    }
+    publicationId_ = static_cast<uint32_t>(std::strtoul(
+        std::string(static_cast<const char*>(publication.data()),
+                    publication.size())
+            .c_str(),
+        nullptr, 10));
+    setReceived();
+  }
 
-      if (!result) {
-        std::cerr << "❌ Не получено подтверждение от сервера" << std::endl;
-        running_ = false;
+  // Прием изменений, пока подписчик не остановлен. Топики данных больше
+  // не нужны: с SUB приходят только изменения
+  void followUpdates(zmq::context_t& context, zmq::socket_t& subscriber) {
+    for (protocol::WireFormat format : candidateFormats()) {
+      subscribe(subscriber, format, false);
+    }
+    std::cout << "🔄 Ожидание изменений (публикация #" << publicationId_
+              << ")..." << std::endl;
+
+    while (running_) {
+      zmq::pollitem_t items[] = {{subscriber.handle(), 0, ZMQ_POLLIN, 0}};
+      zmq::poll(items, 1, POLL_INTERVAL);
+      if (items[0].revents & ZMQ_POLLIN) {
+        receiveDelta(context, subscriber);
+      }
+    }
+  }
+
+  // Прием и применение изменений. Изменения к другой публикации значат,
+  // что часть изменений пропущена (или номер принятого списка неизвестен):
+  // список запрашивается снимком заново
+  void receiveDelta(zmq::context_t& context, zmq::socket_t& subscriber) {
+    zmq::message_t topic;
+    if (!subscriber.recv(topic, zmq::recv_flags::none)) {
+      return;
+    }
+    std::string_view topicName(static_cast<const char*>(topic.data()),
+                               topic.size());
+    if (topicName != protocol::DELTA_TOPIC || !topic.more()) {
+      skipMessage(subscriber, topic);  // повтор данных до отписки
+      return;
+    }
+
+    zmq::message_t parts[4];
+    size_t received = 0;
+    bool more = true;
+    while (more && received < 4 &&
+           subscriber.recv(parts[received], zmq::recv_flags::none)) {
+      more = parts[received++].more();
+    }
+    protocol::DeltaHeader header;
+    if (received < 4 || more ||
+        !protocol::DeltaHeader::decode(parts[0].data(), parts[0].size(),
+                                       header)) {
+      std::cerr << "⚠️  Повреждено сообщение изменений" << std::endl;
+      if (received > 0) {
+        skipMessage(subscriber, parts[received - 1]);
+      }
+      return;
+    }
+
+    uint32_t current = publicationId_;
+    if (current != 0 && header.id <= current) {
+      return;  // изменения уже вошли в принятый снимок
+    }
+    if (header.baseId != current) {
+      std::cerr << "⚠️  Пропущены изменения: принята публикация #" << current
+                << ", изменения к #" << header.baseId << std::endl;
+      if (!snapshotEndpoint_.empty()) {
+        receiveSnapshot(context);
+      }
+      return;
+    }
+
+    DeltaCounts counts;
+    size_t total;
+    {
+      std::lock_guard<std::mutex> lock(dataMutex_);
+      counts = snapshot_.applyDelta(std::move(parts[1]), std::move(parts[2]),
+                                    parts[3]);
+      // Изменения приходят по всему списку: записи чужих шардов могут
+      // быть только добавленными
+      size_t foreign = retainShards(snapshot_);
+      counts.added -= std::min(counts.added, foreign);
+      total = snapshot_.size();
+    }
+    publicationId_ = header.id;
+
+    std::cout << "📥 Изменения #" << header.id << ": добавлено "
+              << counts.added << ", изменено " << counts.updated
+              << ", удалено " << counts.removed << " (студентов: " << total
+              << ")" << std::endl;
+    if (!shardScheme_.enabled() && total != header.recordCount) {
+      std::cerr << "⚠️  После изменений " << total << " студентов, у сервера "
+                << header.recordCount << std::endl;
+    }
+    if (updateHandler_) {
+      updateHandler_(header.id, counts);
+    }
+  }
+
+  // Пропуск оставшихся частей сообщения после части last
+  static void skipMessage(zmq::socket_t& socket, const zmq::message_t& last) {
+    bool more = last.more();
+    while (more) {
+      zmq::message_t part;
+      if (!socket.recv(part, zmq::recv_flags::none)) {
         return;
       }
+      more = part.more();
+    }
+  }
 
-      std::cout << "✅ Получено подтверждение, готов к приему данных"
-                << std::endl;
+  // Ожидание ответа не дольше timeout (0 — без ограничения), пока
+  // подписчик не остановлен
+  bool awaitReply(zmq::socket_t& socket, zmq::message_t& reply,
+                  std::chrono::milliseconds timeout) {
+    auto deadline = timeout.count() > 0
+                        ? std::chrono::steady_clock::now() + timeout
+                        : std::chrono::steady_clock::time_point::max();
+
+    while (running_) {
+      auto now = std::chrono::steady_clock::now();
+      if (now >= deadline) {
+        return false;
+      }
+      auto wait = std::min<std::chrono::steady_clock::duration>(
+          POLL_INTERVAL, deadline - now);
+
+      zmq::pollitem_t items[] = {{socket.handle(), 0, ZMQ_POLLIN, 0}};
+      zmq::poll(items, 1,
+                std::chrono::duration_cast<std::chrono::milliseconds>(wait));
+      if (items[0].revents & ZMQ_POLLIN) {
+        return socket.recv(reply, zmq::recv_flags::none).has_value();
+      }
+    }
+    return false;
+  }
 
-      // Устанавливаем таймаут получения
-      subscriber.set(zmq::sockopt::rcvtimeo, 1000);
+  // Сборка потоковой публикации из пакетов wanted (все пакеты потока или
+  // пакеты запрошенных шардов). Пакеты передаются на разбор по порядку
+  // номеров; пакет, пришедший раньше предыдущих, ждет в early
+  struct StreamState {
+    explicit StreamState(unsigned decodeThreads) : decoder(decodeThreads) {}
+
+    BatchDecoder decoder;
+    bool assembling = false;
+    bool selected = false;  // wanted задан составом шардовой публикации
+    uint32_t streamId = 0;
+    uint32_t batchCount = 0;
+    uint32_t recordCount = 0;
+    std::vector<uint32_t> wanted;  // номера пакетов по возрастанию
+    size_t next = 0;               // позиция в wanted следующего пакета
+    uint32_t highest = 0;          // наибольший принятый номер
+    std::map<uint32_t, zmq::message_t> early;
+
+    std::chrono::steady_clock::time_point lastBatch;
+    std::chrono::steady_clock::time_point lastRequest;
+    size_t nacks = 0;
+    size_t repairedBatches = 0;
+    size_t repairedBytes = 0;
+  };
+
+  // Пакеты запрошенных шардов по составу публикации. Если схема publisher
+  // другая, подписчик подписывается на все шарды, а лишние записи
+  // отбрасывает, приняв список
+  void selectShards(zmq::socket_t& subscriber,
+                    const protocol::ShardManifest& manifest,
+                    StreamState& stream) {
+    if (manifest.scheme != shardScheme_) {
+      std::cerr << "⚠️  Publisher разбивает список на шарды по схеме "
+                << manifest.scheme.encode() << ", принимаются все шарды"
+                << std::endl;
+      subscribe(subscriber, protocol::WireFormat::Sharded, false);
+      shardTopics_ = {std::string(protocol::SHARD_TOPIC)};
+      subscribe(subscriber, protocol::WireFormat::Sharded, true);
+      return;
+    }
 
-      std::cout << "⏳ Ожидание данных..." << std::endl;
+    stream.selected = true;
+    stream.streamId = manifest.streamId;
+    for (const auto& shard : manifest.shards) {
+      if (std::find(shards_.begin(), shards_.end(), shard.name) ==
+          shards_.end()) {
+        continue;
+      }
+      for (uint32_t i = 0; i < shard.batchCount; ++i) {
+        stream.wanted.push_back(shard.firstBatch + i);
+      }
+      stream.recordCount += shard.recordCount;
+    }
+    std::sort(stream.wanted.begin(), stream.wanted.end());
+    std::cout << "🧩 Шарды: " << stream.wanted.size() << " пакетов, "
+              << stream.recordCount << " записей" << std::endl;
+  }
 
-      int attempts = 0;
-      const int MAX_ATTEMPTS = 30;
+  // Прием сообщения SUB: список целиком, пакет потока или описание
+  // сегмента общей памяти. false — сегмент не удалось отобразить
+  bool receiveData(zmq::socket_t& subscriber, StreamState& stream) {
+    zmq::message_t topic;
+    zmq::message_t message;
+    if (!subscriber.recv(topic, zmq::recv_flags::none) || !topic.more()) {
+      return true;
+    }
 
-      while (running_ && attempts < MAX_ATTEMPTS) {
-        try {
-          // Получаем топик
-          zmq::message_t topic;
-          result = subscriber.recv(topic, zmq::recv_flags::none);
+    std::string_view topicName(static_cast<const char*>(topic.data()),
+                               topic.size());
+    // Изменения до приема всего списка не применяются: если они новее
+    // принятого списка, подписчик запросит снимок
+    if (topicName == protocol::DELTA_TOPIC) {
+      skipMessage(subscriber, topic);
+      return true;
+    }
+    if (topicName == protocol::STREAM_TOPIC ||
+        topicName.substr(0, protocol::SHARD_TOPIC.size()) ==
+            protocol::SHARD_TOPIC) {
+      zmq::message_t header;
+      if (subscriber.recv(header, zmq::recv_flags::none) && header.more() &&
+          subscriber.recv(message, zmq::recv_flags::none)) {
+        acceptBatch(header, std::move(message), stream, false);
+      }
+      return true;
+    }
 
-          if (!result) {
-            attempts++;
-            continue;
-          }
+    if (!subscriber.recv(message, zmq::recv_flags::none)) {
+      return true;
+    }
 
-          // Получаем данные
-          zmq::message_t message;
-          result = subscriber.recv(message, zmq::recv_flags::none);
+    // Описание сегмента заменяется отображением сегмента: оно переходит в
+    // снимок так же, как сообщение. Сервер, не создавший сегмент,
+    // публикует в этом топике сами данные
+    if (topicName == protocol::SHARED_TOPIC &&
+        !Serializer::isBinary(message.data(), message.size())) {
+      protocol::SharedDescriptor descriptor;
+      if (!protocol::SharedDescriptor::decode(
+              std::string_view(static_cast<const char*>(message.data()),
+                               message.size()),
+              descriptor) ||
+          !mapShared(descriptor, message)) {
+        return false;
+      }
+      publicationId_ = descriptor.streamId;
+    }
 
-          if (!result) {
-            attempts++;
-            continue;
-          }
+    std::cout << "📥 Данные получены (" << message.size() << " байт)"
+              << std::endl;
+
+    // Разбираем данные в формате, указанном топиком; сообщение переходит в
+    // снимок без копирования
+    protocol::WireFormat dataFormat = topicName == protocol::TEXT_TOPIC
+                                          ? protocol::WireFormat::Text
+                                          : protocol::WireFormat::Binary;
+    StudentSnapshot snapshot =
+        StudentSnapshot::decode(std::move(message), dataFormat);
+
+    std::cout << "✅ Десериализовано " << snapshot.size() << " студентов"
+              << std::endl;
+    retainShards(snapshot);
+    deliverRecords(snapshot);
+
+    // Сохраняем данные
+    {
+      std::lock_guard<std::mutex> lock(dataMutex_);
+      snapshot_ = std::move(snapshot);
+    }
+    if (topicName != protocol::SHARED_TOPIC) {
+      publicationId_ = 0;
+    }
 
-          std::cout << "📥 Данные получены (" << message.size() << " байт)"
-                    << std::endl;
+    setReceived();
+    return true;
+  }
 
-          // Десериализуем данные
-          std::string data(static_cast<char*>(message.data()), message.size());
-          std::vector<Student> students = Serializer::deserialize(data);
+  // Отображение сегмента общей памяти только для чтения в message:
+  // сообщение ZeroMQ ссылается на отображение и освобождает его (munmap)
+  // вместе со снимком, данные не копируются
+  static bool mapShared(const protocol::SharedDescriptor& descriptor,
+                        zmq::message_t& message) {
+    size_t size = static_cast<size_t>(descriptor.size);
+    const void* data = SharedSegment::map(descriptor.name, size);
+    if (data == nullptr) {
+      std::cerr << "⚠️  Сегмент общей памяти " << descriptor.name
+                << " недоступен: " << std::strerror(errno) << std::endl;
+      return false;
+    }
 
-          std::cout << "✅ Десериализовано " << students.size() << " студентов"
-                    << std::endl;
+    std::cout << "📥 Общая память: " << descriptor.name << " (" << size
+              << " байт, публикация #" << descriptor.streamId << ")"
+              << std::endl;
+    message = zmq::message_t(
+        const_cast<void*>(data), size,
+        [](void* mapped, void* hint) {
+          SharedSegment::unmap(mapped, reinterpret_cast<size_t>(hint));
+        },
+        reinterpret_cast<void*>(size));
+    return true;
+  }
 
-          // Сохраняем данные
-          {
-            std::lock_guard<std::mutex> lock(dataMutex_);
-            receivedStudents_ = students;
-          }
+  // Прием пакета, повторно отправленного по запросу (заголовок и записи)
+  void receiveRepair(zmq::socket_t& repairClient, StreamState& stream) {
+    zmq::message_t header;
+    zmq::message_t batch;
+    if (repairClient.recv(header, zmq::recv_flags::none) && header.more() &&
+        repairClient.recv(batch, zmq::recv_flags::none)) {
+      acceptBatch(header, std::move(batch), stream, true);
+    }
+  }
 
-          dataReceived_ = true;
-          break;
+  // Пакет потока. Пакет передается на разбор сразу, если все предыдущие
+  // уже переданы, иначе откладывается до их прихода: пропущенные пакеты
+  // приходят по запросу NACK или при повторной отправке потока
+  void acceptBatch(const zmq::message_t& headerMessage, zmq::message_t&& batch,
+                   StreamState& stream, bool repaired) {
+    protocol::BatchHeader header;
+    if (!protocol::BatchHeader::decode(headerMessage.data(),
+                                       headerMessage.size(), header) ||
+        header.sequence >= header.batchCount) {
+      std::cerr << "⚠️  Поврежден заголовок пакета" << std::endl;
+      return;
+    }
 
-        } catch (const zmq::error_t& e) {
-          if (e.num() != EAGAIN) {
-            throw;
-          }
-          attempts++;
+    // Пакет новой публикации: собранная часть прежней не нужна. Пакеты
+    // шардов выбраны по составу публикации; другой публикации состав
+    // неизвестен, и собираются все ее пакеты
+    if (!stream.assembling || header.streamId != stream.streamId) {
+      stream.early.clear();
+      if (!stream.selected || header.streamId != stream.streamId) {
+        stream.selected = false;
+        stream.recordCount = header.recordCount;
+        stream.wanted.resize(header.batchCount);
+        for (uint32_t i = 0; i < header.batchCount; ++i) {
+          stream.wanted[i] = i;
         }
       }
+      stream.decoder.begin(stream.wanted.size());
+      stream.assembling = true;
+      stream.streamId = header.streamId;
+      stream.batchCount = header.batchCount;
+      stream.next = 0;
+      stream.highest = 0;
+    }
 
-      if (!dataReceived_) {
-        std::cerr << "⚠️  Данные не получены за отведенное время" << std::endl;
+    uint32_t sequence = header.sequence;
+    if (stream.next == stream.wanted.size() ||
+        sequence < stream.wanted[stream.next] ||
+        stream.early.count(sequence) > 0 ||
+        !std::binary_search(stream.wanted.begin() + stream.next,
+                            stream.wanted.end(), sequence)) {
+      return;  // повтор уже принятого пакета или пакет чужого шарда
+    }
+
+    stream.lastBatch = std::chrono::steady_clock::now();
+    stream.highest = std::max(stream.highest, sequence);
+    if (repaired) {
+      stream.repairedBatches++;
+      stream.repairedBytes += batch.size();
+    }
+
+    if (sequence > stream.wanted[stream.next]) {
+      if (stream.early.empty() && !repaired) {
+        std::cerr << "⚠️  Пропуск пакетов: ожидался #"
+                  << stream.wanted[stream.next] << ", получен #" << sequence
+                  << std::endl;
       }
+      stream.early.emplace(sequence, std::move(batch));
+      return;
+    }
 
-    } catch (const zmq::error_t& e) {
-      std::cerr << "❌ ZMQ Synced Subscriber ошибка: " << e.what() << std::endl;
+    stream.decoder.push(std::move(batch));
+    stream.next++;
+    while (!stream.early.empty() && stream.next < stream.wanted.size() &&
+           stream.early.begin()->first == stream.wanted[stream.next]) {
+      stream.decoder.push(std::move(stream.early.begin()->second));
+      stream.early.erase(stream.early.begin());
+      stream.next++;
     }
 
-    running_ = false;
+    if (stream.next == stream.wanted.size()) {
+      finishStream(stream);
+    }
   }
 
+  // Завершение сборки: ожидание разбора последних пакетов и список из них
+  void finishStream(StreamState& stream) {
+    StudentSnapshot pending = stream.decoder.finish();
+    std::cout << "📥 Данные получены (" << pending.batchCount()
+              << " пакетов, " << pending.payloadBytes() << " байт)"
+              << std::endl;
+    if (stream.nacks > 0) {
+      std::cout << "🔁 Запросов NACK: " << stream.nacks
+                << ", восстановлено пакетов: " << stream.repairedBatches
+                << " (" << stream.repairedBytes << " байт)" << std::endl;
+    }
+    if (pending.size() != stream.recordCount) {
+      std::cerr << "⚠️  Принято " << pending.size() << " из "
+                << stream.recordCount << " записей" << std::endl;
+    }
+    std::cout << "✅ Десериализовано " << pending.size() << " студентов"
+              << std::endl;
+    if (!stream.selected) {
+      retainShards(pending);
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(dataMutex_);
+      snapshot_ = std::move(pending);
+    }
+    publicationId_ = stream.streamId;
+    setReceived();
+  }
+
+  // Запрос пропущенных пакетов. Пока поток идет, запрашиваются только
+  // пропуски перед последним принятым пакетом; если пакетов нет дольше
+  // REPAIR_INTERVAL, запрашивается и хвост потока. Запрашиваются только
+  // пакеты wanted, подряд идущие номера — одним запросом. Повторный запрос
+  // — не раньше чем через REPAIR_INTERVAL после предыдущего
+  void requestRepairs(zmq::socket_t& repairClient, StreamState& stream) {
+    if (!stream.assembling) {
+      return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    bool idle = now - stream.lastBatch >= REPAIR_INTERVAL;
+    if ((stream.early.empty() && !idle) ||
+        now - stream.lastRequest < REPAIR_INTERVAL) {
+      return;
+    }
+
+    bool pending = false;
+    uint32_t first = 0;
+    uint32_t last = 0;
+    auto flush = [&] {
+      if (!pending) {
+        return;
+      }
+      std::string nack = protocol::nackMessage(stream.streamId, first, last);
+      zmq::message_t message(nack.data(), nack.size());
+      repairClient.send(message, zmq::send_flags::none);
+      stream.nacks++;
+      std::cout << "🔁 Запрос пакетов #" << first << "-#" << last
+                << std::endl;
+      pending = false;
+    };
+
+    for (size_t i = stream.next; i < stream.wanted.size(); ++i) {
+      uint32_t sequence = stream.wanted[i];
+      if (!idle && sequence >= stream.highest) {
+        break;
+      }
+      if (stream.early.count(sequence) > 0) {
+        flush();
+        continue;
+      }
+      if (pending && sequence == last + 1) {
+        last = sequence;
+        continue;
+      }
+      flush();
+      pending = true;
+      first = last = sequence;
+    }
+    flush();
+    stream.lastRequest = now;
+  }
+
+  // Подписка (subscribe = true) или отписка от топиков формата. Вместо
+  // префикса всех шардов — топики запрошенных шардов
+  void subscribe(zmq::socket_t& subscriber, protocol::WireFormat format,
+                 bool subscribe) const {
+    std::vector<std::string> topics;
+    if (format == protocol::WireFormat::Sharded) {
+      topics = shardTopics_;
+    } else {
+      topics.emplace_back(protocol::topicOf(format));
+    }
+    for (const auto& topic : topics) {
+      if (subscribe) {
+        subscriber.set(zmq::sockopt::subscribe, topic);
+      } else {
+        subscriber.set(zmq::sockopt::unsubscribe, topic);
+      }
+    }
+  }
+
+  // Отбрасывание записей чужих шардов; возвращает число отброшенных
+  size_t retainShards(StudentSnapshot& snapshot) const {
+    if (!shardScheme_.enabled()) {
+      return 0;
+    }
+    size_t before = snapshot.size();
+    snapshot.retain([this](const StudentView& student) {
+      return std::find(shards_.begin(), shards_.end(),
+                       shardScheme_.shardOf(student)) != shards_.end();
+    });
+    if (snapshot.size() != before) {
+      std::cout << "🧩 Оставлены записи шардов: " << snapshot.size() << " из "
+                << before << std::endl;
+    }
+    return before - snapshot.size();
+  }
+
+  // Форматы, в которых могут прийти данные при запрошенном формате.
+  // Текстовый — последним: по подписке на него publisher узнает, что
+  // подписка SUB дошла, и остальные подписки должны дойти раньше
+  std::vector<protocol::WireFormat> candidateFormats() const {
+    std::vector<protocol::WireFormat> formats;
+    if (preferredFormat_ == protocol::WireFormat::Sharded ||
+        preferredFormat_ == protocol::WireFormat::Shared) {
+      formats.push_back(preferredFormat_);
+    }
+    if (preferredFormat_ == protocol::WireFormat::Sharded ||
+        preferredFormat_ == protocol::WireFormat::Stream) {
+      formats.push_back(protocol::WireFormat::Stream);
+    }
+    if (preferredFormat_ != protocol::WireFormat::Text) {
+      formats.push_back(protocol::WireFormat::Binary);
+    }
+    formats.push_back(protocol::WireFormat::Text);
+    return formats;
+  }
+
+  static constexpr std::chrono::milliseconds POLL_INTERVAL{100};
+  static constexpr std::chrono::milliseconds REPAIR_INTERVAL{300};
+  static constexpr std::chrono::milliseconds LINGER{1000};
+  static constexpr std::chrono::seconds DEFAULT_DATA_TIMEOUT{30};
+
   std::string subEndpoint_;
   std::string syncEndpoint_;
+  std::string repairEndpoint_;
+  std::string snapshotEndpoint_;
+  std::chrono::milliseconds syncTimeout_{0};
+  std::chrono::milliseconds dataTimeout_{DEFAULT_DATA_TIMEOUT};
+  protocol::WireFormat preferredFormat_;
   std::atomic<bool> running_;
   std::atomic<bool> dataReceived_;
+  bool liveUpdates_ = false;
+  unsigned decodeThreads_ = 0;
+  RecordHandler recordHandler_;
+  std::mutex readyMutex_;
+  std::condition_variable readyChanged_;
+  std::shared_ptr<zmq::context_t> context_;
+  protocol::ShardScheme shardScheme_;
+  std::vector<std::string> shards_;
+  std::vector<std::string> shardTopics_;
+  UpdateHandler updateHandler_;
+  std::atomic<uint32_t> publicationId_{0};
   std::thread subscribeThread_;
-  std::vector<Student> receivedStudents_;
+  StudentSnapshot snapshot_;
   std::mutex dataMutex_;
 };
\ No newline at end of file
@@ -1,12 +1,69 @@
+#include <atomic>
 #include <chrono>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
-#include <thread>
+#include <string>
+#include <vector>
 
+#include "../common/Endpoints.h"
 #include "../common/Student.h"
 #include "StudentSorter.h"
 #include "ZmqSyncedSubscriber.h"
 
-int main() {
+int main(int argc, char* argv[]) {
+  // --live: после получения списка клиент применяет изменения с сервера,
+  // пока не нажат Enter. --shard=<ключ>[:<ширина>] и имена шардов: клиент
+  // принимает только эти шарды (например, --shard=year 2001 2002).
+  // --transport=tcp[:<хост>]|ipc[:<каталог>]: транспорт (по умолчанию tcp
+  // к localhost). --shm: список через общую память (клиент на одной машине
+  // с сервером). --sort-threads=<n>: потоков сортировки (по умолчанию по
+  // числу ядер, 1 — в одном потоке). --collate=ru: сортировка по русскому
+  // алфавиту (Ё после Е) вместо байтов UTF-8. --top=<k>: только первые k
+  // студентов (без сортировки всего списка). --page=<n>: вывод страницами
+  // по n строк
+  bool live = false;
+  size_t top = 0;
+  size_t pageSize = 0;
+  unsigned sortThreads = 0;
+  NameOrder nameOrder = NameOrder::Bytes;
+  bool sharedMemory = false;
+  protocol::ShardScheme scheme;
+  std::vector<std::string> shards;
+  Endpoints endpoints;
+  Endpoints::forClient("tcp", endpoints);
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--live") == 0) {
+      live = true;
+    } else if (std::strcmp(argv[i], "--shm") == 0) {
+      sharedMemory = true;
+    } else if (std::strncmp(argv[i], "--transport=", 12) == 0) {
+      // inproc:// работает только внутри процесса сервера
+      if (std::strcmp(argv[i] + 12, "inproc") == 0 ||
+          !Endpoints::forClient(argv[i] + 12, endpoints)) {
+        std::cerr << "❌ Неподдерживаемый транспорт: " << argv[i] + 12
+                  << std::endl;
+        return 1;
+      }
+    } else if (std::strncmp(argv[i], "--top=", 6) == 0) {
+      top = std::strtoul(argv[i] + 6, nullptr, 10);
+    } else if (std::strncmp(argv[i], "--page=", 7) == 0) {
+      pageSize = std::strtoul(argv[i] + 7, nullptr, 10);
+    } else if (std::strcmp(argv[i], "--collate=ru") == 0) {
+      nameOrder = NameOrder::Russian;
+    } else if (std::strncmp(argv[i], "--sort-threads=", 15) == 0) {
+      sortThreads = static_cast<unsigned>(std::strtoul(argv[i] + 15,
+                                                       nullptr, 10));
+    } else if (std::strncmp(argv[i], "--shard=", 8) == 0) {
+      if (!protocol::ShardScheme::fromOption(argv[i] + 8, scheme)) {
+        std::cerr << "❌ Неизвестная схема шардов: " << argv[i] << std::endl;
+        return 1;
+      }
+    } else {
+      shards.push_back(argv[i]);
+    }
+  }
+
   std::cout << "╔════════════════════════════════════════════════════╗"
             << std::endl;
   std::cout << "║          КЛИЕНТ УПРАВЛЕНИЯ СТУДЕНТАМИ              ║"
@@ -18,25 +75,48 @@ int main() {
   // Шаг 1: Подключение к серверу
   std::cout << "📖 ШАГ 1: Подключение к серверу\n" << std::endl;
 
-  ZmqSyncedSubscriber subscriber("tcp://localhost:5555",
-                                 "tcp://localhost:5556");
+  ZmqSyncedSubscriber subscriber(endpoints.pub, endpoints.sync,
+                                 sharedMemory
+                                     ? protocol::WireFormat::Shared
+                                     : protocol::WireFormat::Stream);
+  subscriber.setRepairEndpoint(endpoints.repair);
+  // Если сервер не ответил на сигнал готовности (публикация уже идет или
+  // завершилась), список запрашивается снимком
+  subscriber.setSnapshotEndpoint(endpoints.snapshot);
+  subscriber.setSyncTimeout(std::chrono::seconds(5));
+  subscriber.setLiveUpdates(live);
+  if (scheme.enabled()) {
+    subscriber.setShards(scheme, shards);
+  }
+
+  // Записи считаются по мере разбора пакетов, до сборки всего списка
+  std::atomic<size_t> arrived(0);
+  subscriber.setRecordHandler([&](const std::vector<StudentView>& records) {
+    arrived += records.size();
+  });
 
   // Запускаем подписку в отдельном потоке
   subscriber.start();
 
-  // Ждем получения данных
+  // Ждем получения данных: подписчик сообщает о приеме сам, без опроса
   std::cout << "\n⏳ Ожидание данных от сервера..." << std::endl;
 
   int waitTime = 0;
   const int MAX_WAIT_TIME = 60;  // 60 секунд
+  const int PROGRESS_INTERVAL = 5;
 
-  while (!subscriber.isDataReceived() && waitTime < MAX_WAIT_TIME) {
-    std::this_thread::sleep_for(std::chrono::seconds(1));
-    waitTime++;
+  while (subscriber.isRunning() && waitTime < MAX_WAIT_TIME &&
+         !subscriber.waitForData(std::chrono::seconds(PROGRESS_INTERVAL))) {
+    waitTime += PROGRESS_INTERVAL;
+    std::cout << "   Ожидание... (" << waitTime << " сек, принято записей: "
+              << arrived << ")" << std::endl;
+  }
 
-    if (waitTime % 5 == 0) {
-      std::cout << "   Ожидание... (" << waitTime << " сек)" << std::endl;
-    }
+  if (live && subscriber.isDataReceived()) {
+    std::cout << "\n🔄 Применение изменений с сервера (Enter — показать "
+                 "итоговый список)"
+              << std::endl;
+    std::cin.get();
   }
 
   // Останавливаем subscriber
@@ -52,7 +132,8 @@ int main() {
   // Шаг 2: Получение данных
   std::cout << "\n📖 ШАГ 2: Обработка полученных данных\n" << std::endl;
 
-  auto students = subscriber.getReceivedData();
+  // Данные остаются в принятом сообщении, сортируются представления
+  StudentSnapshot students = subscriber.takeSnapshot();
 
   if (students.empty()) {
     std::cerr << "⚠️  Предупреждение: Получен пустой список студентов"
@@ -65,12 +146,26 @@ int main() {
   // Шаг 3: Сортировка студентов
   std::cout << "\n📖 ШАГ 3: Сортировка студентов по ФИО\n" << std::endl;
 
-  StudentSorter::sortByFullName(students);
+  // С --top сортируются только первые top записей
+  std::vector<StudentView> first;
+  if (top > 0) {
+    first = StudentSorter::firstByFullName(students, top, nameOrder);
+    std::cout << "✅ Отобрано первых студентов: " << first.size() << " из "
+              << students.size() << std::endl;
+  } else {
+    StudentSorter::sortByFullName(students, sortThreads, nameOrder);
+  }
 
   // Шаг 4: Вывод на экран
   std::cout << "\n📖 ШАГ 4: Отображение результатов\n" << std::endl;
 
-  StudentSorter::displayStudents(students);
+  auto begin = top > 0 ? first.cbegin() : students.views().cbegin();
+  auto end = top > 0 ? first.cend() : students.views().cend();
+  if (pageSize > 0) {
+    StudentSorter::displayPaged(begin, end, pageSize, std::cin);
+  } else {
+    StudentSorter::displayStudents(begin, end);
+  }
 
   std::cout << "\n✅ Клиент завершил работу" << std::endl;
 
@@ -82,5 +177,7 @@ int main() {
  * g++ -std=c++17 client_main.cpp -o client -lzmq -pthread
  *
  * Запуск:
- * ./client
+ * ./client [--live] [--shm] [--transport=tcp[:хост]|ipc[:каталог]]
+ *          [--sort-threads=N] [--collate=ru] [--top=K] [--page=N]
+ *          [--shard=initial|year|id[:ширина] шард...]
  */
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <zmq.hpp>
+
+#include "../common/Endpoints.h"
+#include "../common/Protocol.h"
+#include "../common/Validator.h"
+#include "StudentSnapshot.h"
+#include "StudentSorter.h"
+
+// Запрос к сервису запросов сервера: поиск студентов без приема всего
+// списка
+int main(int argc, char* argv[]) {
+  Endpoints endpoints;
+  Endpoints::forClient("tcp", endpoints);
+  std::vector<std::string> arguments;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strncmp(argv[i], "--transport=", 12) == 0) {
+      if (std::strcmp(argv[i] + 12, "inproc") == 0 ||
+          !Endpoints::forClient(argv[i] + 12, endpoints)) {
+        std::cerr << "❌ Неподдерживаемый транспорт: " << argv[i] + 12
+                  << std::endl;
+        return 1;
+      }
+    } else {
+      arguments.push_back(argv[i]);
+    }
+  }
+
+  // id <ID> | name <начало ФИО...> | dates <ДД.ММ.ГГГГ> <ДД.ММ.ГГГГ>
+  protocol::Query query;
+  bool valid = false;
+  if (arguments.size() == 2 && arguments[0] == "id") {
+    char* end = nullptr;
+    query.kind = protocol::QueryKind::Id;
+    query.id = static_cast<int>(std::strtol(arguments[1].c_str(), &end, 10));
+    valid = *end == '\0';
+  } else if (arguments.size() >= 2 && arguments[0] == "name") {
+    query.kind = protocol::QueryKind::Name;
+    for (size_t i = 1; i < arguments.size(); ++i) {
+      query.namePrefix += (i > 1 ? " " : "") + arguments[i];
+    }
+    valid = !query.namePrefix.empty();
+  } else if (arguments.size() == 3 && arguments[0] == "dates") {
+    query.kind = protocol::QueryKind::Dates;
+    valid = Validator::tryParseDate(arguments[1], query.from) &&
+            Validator::tryParseDate(arguments[2], query.to);
+  }
+  if (!valid) {
+    std::cerr << "Использование: " << argv[0]
+              << " [--transport=tcp[:хост]|ipc[:каталог]]\n"
+              << "       id <ID> | name <начало ФИО> |"
+              << " dates <ДД.ММ.ГГГГ> <ДД.ММ.ГГГГ>" << std::endl;
+    return 1;
+  }
+
+  const std::chrono::milliseconds REPLY_TIMEOUT(5000);
+
+  try {
+    zmq::context_t context(1);
+    zmq::socket_t socket(context, zmq::socket_type::req);
+    socket.set(zmq::sockopt::linger, 0);
+    socket.connect(endpoints.query);
+
+    std::string request = protocol::queryRequest(query);
+    zmq::message_t requestMessage(request.data(), request.size());
+    socket.send(requestMessage, zmq::send_flags::none);
+
+    zmq::pollitem_t items[] = {{socket.handle(), 0, ZMQ_POLLIN, 0}};
+    zmq::poll(items, 1, REPLY_TIMEOUT);
+    if (!(items[0].revents & ZMQ_POLLIN)) {
+      std::cerr << "❌ Сервер не ответил: " << endpoints.query << std::endl;
+      return 1;
+    }
+
+    zmq::message_t status;
+    zmq::message_t data;
+    socket.recv(status, zmq::recv_flags::none);
+    if (status.more()) {
+      socket.recv(data, zmq::recv_flags::none);
+    }
+
+    std::string statusText(static_cast<const char*>(status.data()),
+                           status.size());
+    if (statusText.rfind(protocol::OK, 0) != 0) {
+      std::cerr << "❌ " << statusText << std::endl;
+      return 1;
+    }
+
+    StudentSnapshot found =
+        StudentSnapshot::decode(std::move(data), protocol::WireFormat::Binary);
+    StudentSorter::displayStudents(found);
+    size_t total = std::strtoul(statusText.c_str() + protocol::OK.size(),
+                                nullptr, 10);
+    if (total > found.size()) {
+      std::cout << "Показаны первые " << found.size() << " из " << total
+                << std::endl;
+    }
+  } catch (const zmq::error_t& e) {
+    std::cerr << "❌ ZMQ ошибка: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+/*
+ * Запуск:
+ * ./query_app [--transport=tcp[:хост]|ipc[:каталог]] id 42
+ * ./query_app name Ivan Ivanovich
+ * ./query_app dates 01.01.1988 31.12.1988
+ */
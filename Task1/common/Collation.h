@@ -0,0 +1,200 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Student.h"
+
+// Порядок сортировки ФИО
+enum class NameOrder {
+  Bytes,    // байты UTF-8 строки getFullName() (Ё после Я, латиница раньше)
+  Russian,  // русский алфавит (RussianCollation)
+};
+
+// Ключ сопоставления, ссылающийся на чужие байты. Ключи сравниваются
+// memcmp; более короткий ключ, совпадающий с началом другого, меньше
+struct CollationKeyRef {
+  std::string_view bytes;
+
+  int compare(const CollationKeyRef& other) const {
+    size_t length = std::min(bytes.size(), other.bytes.size());
+    int result = length == 0
+                     ? 0
+                     : std::memcmp(bytes.data(), other.bytes.data(), length);
+    if (result != 0) {
+      return result;
+    }
+    return bytes.size() < other.bytes.size()
+               ? -1
+               : bytes.size() > other.bytes.size() ? 1 : 0;
+  }
+
+  // Первые 8 байт ключа одним числом, как FullNameRef::prefix()
+  uint64_t prefix() const {
+    uint64_t result = 0;
+    size_t length = std::min<size_t>(bytes.size(), 8);
+    for (size_t i = 0; i < 8; ++i) {
+      result <<= 8;
+      if (i < length) {
+        result |= static_cast<unsigned char>(bytes[i]);
+      }
+    }
+    return result;
+  }
+};
+
+// Ключи сопоставления ФИО по русскому алфавиту. Ключ строится один раз на
+// имя, дальше имена сравниваются memcmp ключей, без std::locale и strcoll.
+// Ключ — два уровня, разделенных нулевым байтом:
+// - основной: вес каждой буквы без учета регистра (пробел между частями
+//   ФИО меньше любой буквы, латиница A-Z раньше кириллицы, кириллица по
+//   алфавиту: А Б В Г Д Е Ё Ж ... Я); прочие байты — после букв, в порядке
+//   значений;
+// - регистр: по байту на букву (строчная раньше прописной).
+// Разные ФИО получают разные ключи, поэтому порядок полный
+class RussianCollation {
+ public:
+  static std::string key(const FullNameRef& name) {
+    std::string result;
+    appendKey(name, result);
+    return result;
+  }
+
+  static void appendKey(const FullNameRef& name, std::string& key) {
+    const std::string_view parts[] = {name.first, name.middle, name.last};
+    for (size_t part = 0; part < 3; ++part) {
+      if (part > 0) {
+        key.push_back(static_cast<char>(SEPARATOR));
+      }
+      forEachLetter(parts[part], [&](uint8_t weight, uint8_t, uint8_t raw) {
+        key.push_back(static_cast<char>(weight));
+        if (weight == OTHER) {
+          key.push_back(static_cast<char>(raw));
+        }
+      });
+    }
+
+    key.push_back('\0');
+    size_t levelStart = key.size();
+    for (size_t part = 0; part < 3; ++part) {
+      forEachLetter(parts[part], [&](uint8_t weight, uint8_t caseWeight,
+                                     uint8_t) {
+        if (weight != OTHER) {
+          key.push_back(static_cast<char>(caseWeight));
+        }
+      });
+    }
+    // Уровень регистра без прописных букв не нужен: ключи короче
+    if (std::all_of(key.begin() + levelStart, key.end(),
+                    [](char c) { return c == LOWER; })) {
+      key.resize(levelStart - 1);
+    }
+  }
+
+ private:
+  static constexpr uint8_t SEPARATOR = 0x01;
+  static constexpr uint8_t LATIN = 0x02;     // A-Z: 0x02..0x1B
+  static constexpr uint8_t CYRILLIC = 0x20;  // А-Я и Ё: 0x20..0x40
+  static constexpr uint8_t OTHER = 0xFF;     // затем сам байт
+  static constexpr uint8_t LOWER = 0x01;
+  static constexpr uint8_t UPPER = 0x02;
+
+  // Кириллица UTF-8: двухбайтовые коды U+0401 (Ё), U+0410..U+044F (А-я),
+  // U+0451 (ё). fn(вес, регистр, байт) вызывается для каждой буквы;
+  // непонятный байт — вес OTHER с самим байтом
+  template <typename Fn>
+  static void forEachLetter(std::string_view text, Fn fn) {
+    for (size_t i = 0; i < text.size(); ++i) {
+      uint8_t byte = static_cast<uint8_t>(text[i]);
+      if (byte >= 'A' && byte <= 'Z') {
+        fn(static_cast<uint8_t>(LATIN + (byte - 'A')), UPPER, byte);
+        continue;
+      }
+      if (byte >= 'a' && byte <= 'z') {
+        fn(static_cast<uint8_t>(LATIN + (byte - 'a')), LOWER, byte);
+        continue;
+      }
+
+      if ((byte == 0xD0 || byte == 0xD1) && i + 1 < text.size()) {
+        uint8_t next = static_cast<uint8_t>(text[i + 1]);
+        unsigned code = ((byte & 0x1Fu) << 6) | (next & 0x3Fu);
+        int letter = -1;
+        uint8_t caseWeight = UPPER;
+        if ((next & 0xC0) == 0x80) {
+          if (code == 0x401 || code == 0x451) {
+            letter = 6;  // Ё — сразу после Е
+            caseWeight = code == 0x401 ? UPPER : LOWER;
+          } else if (code >= 0x410 && code <= 0x44F) {
+            caseWeight = code < 0x430 ? UPPER : LOWER;
+            letter = static_cast<int>((code - 0x410) % 32);
+            if (letter >= 6) {
+              letter++;
+            }
+          }
+        }
+        if (letter >= 0) {
+          fn(static_cast<uint8_t>(CYRILLIC + letter), caseWeight, byte);
+          i++;
+          continue;
+        }
+      }
+
+      fn(OTHER, LOWER, byte);
+    }
+  }
+};
+
+// Ключи сопоставления набора записей в одном буфере: для строки row —
+// отрезок буфера. Ключи можно переставлять вместе с записями (reorder),
+// не перестраивая
+class CollationKeys {
+ public:
+  // Ключи строк 0..count-1; nameOf(row) возвращает FullNameRef
+  template <typename NameOf>
+  void build(size_t count, NameOf nameOf) {
+    clear();
+    spans_.reserve(count);
+    for (size_t row = 0; row < count; ++row) {
+      size_t offset = bytes_.size();
+      RussianCollation::appendKey(nameOf(row), bytes_);
+      spans_.push_back(Span{offset, bytes_.size() - offset});
+    }
+  }
+
+  // Новый порядок строк: строка i получает ключ строки order[i]
+  void reorder(const std::vector<uint32_t>& order) {
+    std::vector<Span> spans;
+    spans.reserve(order.size());
+    for (uint32_t row : order) {
+      spans.push_back(spans_[row]);
+    }
+    spans_ = std::move(spans);
+  }
+
+  void clear() {
+    bytes_.clear();
+    spans_.clear();
+  }
+
+  size_t size() const { return spans_.size(); }
+  bool empty() const { return spans_.empty(); }
+
+  CollationKeyRef operator[](size_t row) const {
+    return CollationKeyRef{
+        std::string_view(bytes_.data() + spans_[row].offset,
+                         spans_[row].size)};
+  }
+
+ private:
+  struct Span {
+    size_t offset;
+    size_t size;
+  };
+
+  std::string bytes_;
+  std::vector<Span> spans_;
+};
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+// Адреса сокетов сервера: данные (PUB), синхронизация, канал
+// восстановления, сервис снимков и сервис запросов. Сервер привязывает
+// сокеты (bind), клиент подключается (connect) к адресам того же
+// транспорта:
+// - "tcp[:<хост>]" — порты 5555-5559; сервер слушает все интерфейсы или
+//   указанный хост, клиент подключается к хосту (по умолчанию localhost);
+// - "ipc[:<каталог>]" — сокеты Unix в каталоге (по умолчанию /tmp), для
+//   клиентов на той же машине без стека TCP;
+// - "inproc" — внутри одного процесса: publisher и подписчики должны
+//   использовать общий контекст ZeroMQ (setContext)
+struct Endpoints {
+  std::string pub;
+  std::string sync;
+  std::string repair;
+  std::string snapshot;
+  std::string query;
+
+  static constexpr int BASE_PORT = 5555;
+
+  static bool forServer(std::string_view transport, Endpoints& endpoints) {
+    return make(transport, true, endpoints);
+  }
+
+  static bool forClient(std::string_view transport, Endpoints& endpoints) {
+    return make(transport, false, endpoints);
+  }
+
+ private:
+  static bool make(std::string_view transport, bool server,
+                   Endpoints& endpoints) {
+    size_t colon = transport.find(':');
+    std::string_view kind = transport.substr(0, colon);
+    std::string argument(colon == std::string_view::npos
+                             ? std::string_view()
+                             : transport.substr(colon + 1));
+
+    std::string* addresses[] = {&endpoints.pub, &endpoints.sync,
+                                &endpoints.repair, &endpoints.snapshot,
+                                &endpoints.query};
+    const char* names[] = {"pub", "sync", "repair", "snapshot", "query"};
+    const int COUNT = 5;
+
+    if (kind == "tcp") {
+      std::string host =
+          !argument.empty() ? argument : server ? "*" : "localhost";
+      for (int i = 0; i < COUNT; ++i) {
+        *addresses[i] = "tcp://" + host + ":" + std::to_string(BASE_PORT + i);
+      }
+    } else if (kind == "ipc") {
+      std::string directory = !argument.empty() ? argument : "/tmp";
+      for (int i = 0; i < COUNT; ++i) {
+        *addresses[i] =
+            "ipc://" + directory + "/students-" + names[i] + ".ipc";
+      }
+    } else if (kind == "inproc") {
+      for (int i = 0; i < COUNT; ++i) {
+        *addresses[i] = std::string("inproc://students-") + names[i];
+      }
+    } else {
+      return false;
+    }
+    return true;
+  }
+};
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NAME_SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+// Проверка того, что все байты строки допустимы в имени: латинские буквы,
+// байты 0x81, 0x8F и диапазон 0x90-0xD1. Это ровно те байты, которые
+// принимало прежнее регулярное выражение [A-Za-zА-Яа-яЁё] (std::regex<char>
+// сравнивает побайтово), и они покрывают UTF-8 букв А-Я, а-я, Ё, ё. На x86
+// байты классифицируются блоками по 16 (SSE2) или 32 (AVX2) байта,
+// реализация выбирается при первом вызове по возможностям процессора
+namespace name_scan {
+
+// Байт-заполнитель для неполного блока: сам по себе допустим. Хвост
+// строки короче блока копируется в блок на стеке, дополненный этим байтом:
+// читать за концом строки нельзя, даже в пределах страницы
+constexpr char PAD_BYTE = 'a';
+
+constexpr std::array<bool, 256> makeTable() {
+  std::array<bool, 256> table{};
+  for (int c = 'A'; c <= 'Z'; ++c) table[c] = true;
+  for (int c = 'a'; c <= 'z'; ++c) table[c] = true;
+  for (int c = 0x90; c <= 0xD1; ++c) table[c] = true;
+  table[0x81] = true;
+  table[0x8F] = true;
+  return table;
+}
+
+inline constexpr std::array<bool, 256> TABLE = makeTable();
+
+inline bool scalar(const char* data, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    if (!TABLE[static_cast<unsigned char>(data[i])]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+#ifdef NAME_SCAN_X86
+
+// Маска допустимых байтов. Беззнаковые проверки диапазонов сводятся к
+// знаковому сравнению сдвигом диапазона к -128: (c | 0x20) в 'a'..'z' —
+// латинская буква любого регистра, c в 0x90..0xD1 — кириллица
+__attribute__((target("sse2"))) inline __m128i classifySse2(__m128i bytes) {
+  __m128i lower = _mm_or_si128(bytes, _mm_set1_epi8(0x20));
+  __m128i letter = _mm_cmplt_epi8(
+      _mm_add_epi8(lower, _mm_set1_epi8(static_cast<char>(0x80 - 'a'))),
+      _mm_set1_epi8(static_cast<char>(-128 + 26)));
+  __m128i cyrillic = _mm_cmplt_epi8(
+      _mm_add_epi8(bytes, _mm_set1_epi8(static_cast<char>(0x80 - 0x90))),
+      _mm_set1_epi8(static_cast<char>(-128 + 0xD1 - 0x90 + 1)));
+  __m128i yo = _mm_or_si128(
+      _mm_cmpeq_epi8(bytes, _mm_set1_epi8(static_cast<char>(0x81))),
+      _mm_cmpeq_epi8(bytes, _mm_set1_epi8(static_cast<char>(0x8F))));
+  return _mm_or_si128(_mm_or_si128(letter, cyrillic), yo);
+}
+
+__attribute__((target("sse2"))) inline bool sse2(const char* data,
+                                                 size_t size) {
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    __m128i bytes =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    if (_mm_movemask_epi8(classifySse2(bytes)) != 0xFFFF) {
+      return false;
+    }
+  }
+  if (i < size) {
+    alignas(16) char tail[16];
+    std::memset(tail, PAD_BYTE, sizeof(tail));
+    std::memcpy(tail, data + i, size - i);
+    __m128i bytes = _mm_load_si128(reinterpret_cast<const __m128i*>(tail));
+    if (_mm_movemask_epi8(classifySse2(bytes)) != 0xFFFF) {
+      return false;
+    }
+  }
+  return true;
+}
+
+__attribute__((target("avx2"))) inline __m256i classifyAvx2(__m256i bytes) {
+  __m256i lower = _mm256_or_si256(bytes, _mm256_set1_epi8(0x20));
+  __m256i letter = _mm256_cmpgt_epi8(
+      _mm256_set1_epi8(static_cast<char>(-128 + 26)),
+      _mm256_add_epi8(lower, _mm256_set1_epi8(static_cast<char>(0x80 - 'a'))));
+  __m256i cyrillic = _mm256_cmpgt_epi8(
+      _mm256_set1_epi8(static_cast<char>(-128 + 0xD1 - 0x90 + 1)),
+      _mm256_add_epi8(bytes, _mm256_set1_epi8(static_cast<char>(0x80 - 0x90))));
+  __m256i yo = _mm256_or_si256(
+      _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(static_cast<char>(0x81))),
+      _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(static_cast<char>(0x8F))));
+  return _mm256_or_si256(_mm256_or_si256(letter, cyrillic), yo);
+}
+
+__attribute__((target("avx2"))) inline bool avx2(const char* data,
+                                                 size_t size) {
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    __m256i bytes =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+    if (_mm256_movemask_epi8(classifyAvx2(bytes)) != -1) {
+      return false;
+    }
+  }
+  if (i < size) {
+    alignas(32) char tail[32];
+    std::memset(tail, PAD_BYTE, sizeof(tail));
+    std::memcpy(tail, data + i, size - i);
+    __m256i bytes = _mm256_load_si256(reinterpret_cast<const __m256i*>(tail));
+    if (_mm256_movemask_epi8(classifyAvx2(bytes)) != -1) {
+      return false;
+    }
+  }
+  return true;
+}
+
+#endif
+
+using Kernel = bool (*)(const char*, size_t);
+
+// Выбор реализации по возможностям процессора
+inline Kernel selectKernel() {
+#ifdef NAME_SCAN_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return avx2;
+  }
+  if (__builtin_cpu_supports("sse2")) {
+    return sse2;
+  }
+#endif
+  return scalar;
+}
+
+// Реализация, выбранная для текущего процессора
+inline Kernel kernel() {
+  static const Kernel selected = selectKernel();
+  return selected;
+}
+
+inline bool allNameBytes(const char* data, size_t size) {
+  return kernel()(data, size);
+}
+
+}  // namespace name_scan
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Количество рабочих потоков по умолчанию (число ядер, минимум 1)
+inline unsigned defaultThreadCount() {
+  unsigned count = std::thread::hardware_concurrency();
+  return count > 0 ? count : 1;
+}
+
+// Вызывает fn(i) для каждого i из [0, count) на threadCount потоках.
+// Задачи раздаются через атомарный счетчик; при одном потоке или одной
+// задаче все выполняется в вызывающем потоке. threadCount == 0 — по числу
+// ядер
+template <typename Fn>
+void parallelFor(size_t count, unsigned threadCount, Fn fn) {
+  if (threadCount == 0) {
+    threadCount = defaultThreadCount();
+  }
+  threadCount = static_cast<unsigned>(
+      std::min<size_t>(threadCount, count));
+
+  if (threadCount <= 1) {
+    for (size_t i = 0; i < count; ++i) {
+      fn(i);
+    }
+    return;
+  }
+
+  std::atomic<size_t> next(0);
+  auto worker = [&]() {
+    for (size_t i = next++; i < count; i = next++) {
+      fn(i);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(threadCount - 1);
+  for (unsigned t = 1; t < threadCount; ++t) {
+    threads.emplace_back(worker);
+  }
+  worker();
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
\ No newline at end of file
@@ -0,0 +1,585 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Student.h"
+#include "Validator.h"
+
+// Сообщения синхронизации и топики публикации, общие для сервера и клиента
+namespace protocol {
+
+// Формат данных публикации. Stream — двоичный формат, разбитый на пакеты
+// по BatchHeader; Sharded — те же пакеты, разложенные по топикам шардов;
+// Shared — двоичный формат в общей памяти, публикуется только
+// SharedDescriptor (для подписчиков на той же машине)
+enum class WireFormat { Text, Binary, Stream, Sharded, Shared };
+
+// Топик текстового формата (Serializer::serialize)
+inline constexpr std::string_view TEXT_TOPIC = "students";
+// Топик двоичного формата (Serializer::serializeBinary). Не начинается с
+// "students": подписка ZeroMQ работает по префиксу, и старые клиенты не
+// должны получать двоичные данные
+inline constexpr std::string_view BINARY_TOPIC = "bstudents";
+// Топик потоковой публикации: сообщение из трех частей — топик,
+// BatchHeader и пакет записей в двоичном формате
+inline constexpr std::string_view STREAM_TOPIC = "sstudents";
+// Префикс топиков шардов: пакет шарда публикуется в топике
+// "pstudents/<шард>/". Подписка на топик шарда оставляет подписчику только
+// этот шард (фильтр по префиксу работает на стороне publisher), подписка на
+// сам префикс — все шарды
+inline constexpr std::string_view SHARD_TOPIC = "pstudents";
+// Топик общей памяти: сообщение из двух частей — топик и SharedDescriptor
+inline constexpr std::string_view SHARED_TOPIC = "mstudents";
+
+// Подписчик сообщает о готовности: "READY" — старый клиент (только текст),
+// "READY BIN" — клиент, принимающий двоичный формат, "READY STREAM BIN" —
+// клиент, принимающий пакеты, "READY SHARDED STREAM BIN" — пакеты по
+// шардам, "READY SHM BIN" — общую память. Publisher отвечает "OK",
+// "OK BIN", "OK STREAM BIN", "OK SHARDED STREAM BIN" или "OK SHM BIN" —
+// формат, в котором придут данные; ответ для шардов содержит второй частью
+// ShardManifest. Суффиксы заканчиваются на " STREAM BIN" и " BIN": сервер,
+// не знающий шардов, пакетов или общей памяти, отправит такому клиенту
+// поток целиком или двоичный формат целиком
+inline constexpr std::string_view READY = "READY";
+inline constexpr std::string_view OK = "OK";
+inline constexpr std::string_view BINARY_SUFFIX = " BIN";
+inline constexpr std::string_view STREAM_SUFFIX = " STREAM BIN";
+inline constexpr std::string_view SHARDED_SUFFIX = " SHARDED STREAM BIN";
+inline constexpr std::string_view SHARED_SUFFIX = " SHM BIN";
+
+inline std::string withFormat(std::string_view message, WireFormat format) {
+  std::string result(message);
+  if (format == WireFormat::Binary) {
+    result += BINARY_SUFFIX;
+  } else if (format == WireFormat::Stream) {
+    result += STREAM_SUFFIX;
+  } else if (format == WireFormat::Sharded) {
+    result += SHARDED_SUFFIX;
+  } else if (format == WireFormat::Shared) {
+    result += SHARED_SUFFIX;
+  }
+  return result;
+}
+
+inline std::string readyMessage(WireFormat format) {
+  return withFormat(READY, format);
+}
+
+inline std::string okMessage(WireFormat format) {
+  return withFormat(OK, format);
+}
+
+inline bool endsWith(std::string_view message, std::string_view suffix) {
+  return message.size() > suffix.size() &&
+         message.substr(message.size() - suffix.size()) == suffix;
+}
+
+// Формат из сообщения READY или OK: всё, кроме "... BIN", — текст
+inline WireFormat parseFormat(std::string_view message) {
+  if (endsWith(message, SHARDED_SUFFIX)) return WireFormat::Sharded;
+  if (endsWith(message, STREAM_SUFFIX)) return WireFormat::Stream;
+  if (endsWith(message, SHARED_SUFFIX)) return WireFormat::Shared;
+  if (endsWith(message, BINARY_SUFFIX)) return WireFormat::Binary;
+  return WireFormat::Text;
+}
+
+inline const char* formatName(WireFormat format) {
+  switch (format) {
+    case WireFormat::Binary:
+      return "двоичный";
+    case WireFormat::Stream:
+      return "поток пакетов";
+    case WireFormat::Sharded:
+      return "пакеты по шардам";
+    case WireFormat::Shared:
+      return "общая память";
+    default:
+      return "текст";
+  }
+}
+
+// Топик, в котором публикуются данные формата format
+inline std::string_view topicOf(WireFormat format) {
+  switch (format) {
+    case WireFormat::Binary:
+      return BINARY_TOPIC;
+    case WireFormat::Stream:
+      return STREAM_TOPIC;
+    case WireFormat::Sharded:
+      return SHARD_TOPIC;
+    case WireFormat::Shared:
+      return SHARED_TOPIC;
+    default:
+      return TEXT_TOPIC;
+  }
+}
+
+// Заголовок пакета потоковой публикации (17 байт, little-endian):
+// номер публикации u32, номер пакета u32, число пакетов u32, число записей
+// во всей публикации u32, флаги u8. Номера пакетов идут подряд с нуля,
+// последний пакет помечен FLAG_END_OF_STREAM
+struct BatchHeader {
+  static constexpr size_t SIZE = 17;
+  static constexpr uint8_t FLAG_END_OF_STREAM = 1;
+
+  uint32_t streamId = 0;
+  uint32_t sequence = 0;
+  uint32_t batchCount = 0;
+  uint32_t recordCount = 0;
+  uint8_t flags = 0;
+
+  bool endOfStream() const { return (flags & FLAG_END_OF_STREAM) != 0; }
+
+  std::string encode() const {
+    std::string data;
+    data.reserve(SIZE);
+    for (uint32_t value : {streamId, sequence, batchCount, recordCount}) {
+      for (int shift = 0; shift < 32; shift += 8) {
+        data += static_cast<char>((value >> shift) & 0xFF);
+      }
+    }
+    data += static_cast<char>(flags);
+    return data;
+  }
+
+  // false, если размер не совпадает с SIZE
+  static bool decode(const void* data, size_t size, BatchHeader& header) {
+    if (size != SIZE) {
+      return false;
+    }
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint32_t* fields[] = {&header.streamId, &header.sequence,
+                          &header.batchCount, &header.recordCount};
+    for (uint32_t* field : fields) {
+      *field = static_cast<uint32_t>(bytes[0]) |
+               (static_cast<uint32_t>(bytes[1]) << 8) |
+               (static_cast<uint32_t>(bytes[2]) << 16) |
+               (static_cast<uint32_t>(bytes[3]) << 24);
+      bytes += 4;
+    }
+    header.flags = bytes[0];
+    return true;
+  }
+};
+
+// Сегмент общей памяти с публикацией в двоичном формате. Текст: "<имя
+// сегмента> <размер> <номер публикации>". Подписчик отображает сегмент
+// только для чтения; сегмент существует, пока publisher не начал новую
+// публикацию или не остановлен
+struct SharedDescriptor {
+  std::string name;
+  uint64_t size = 0;
+  uint32_t streamId = 0;
+
+  std::string encode() const {
+    return name + ' ' + std::to_string(size) + ' ' + std::to_string(streamId);
+  }
+
+  static bool decode(std::string_view text, SharedDescriptor& descriptor) {
+    std::istringstream input{std::string(text)};
+    return static_cast<bool>(input >> descriptor.name >> descriptor.size >>
+                             descriptor.streamId) &&
+           !descriptor.name.empty() && descriptor.name[0] == '/';
+  }
+};
+
+// Топик изменений списка: сообщение из пяти частей — топик, DeltaHeader и
+// три блока записей в двоичном формате: добавленные, измененные (новое
+// значение целиком) и удаленные студенты. Студент определяется ключом
+// объединения (ФИО и дата рождения). Не совпадает по префиксу с топиками
+// данных, старые клиенты изменения не получают
+inline constexpr std::string_view DELTA_TOPIC = "dstudents";
+
+// Заголовок изменений (12 байт, little-endian): номер публикации, к
+// которой применяются изменения, u32, номер публикации после них u32,
+// число студентов после изменений u32. Подписчик, у которого другой номер
+// публикации, пропустил изменения и запрашивает снимок
+struct DeltaHeader {
+  static constexpr size_t SIZE = 12;
+
+  uint32_t baseId = 0;
+  uint32_t id = 0;
+  uint32_t recordCount = 0;
+
+  std::string encode() const {
+    std::string data;
+    data.reserve(SIZE);
+    for (uint32_t value : {baseId, id, recordCount}) {
+      for (int shift = 0; shift < 32; shift += 8) {
+        data += static_cast<char>((value >> shift) & 0xFF);
+      }
+    }
+    return data;
+  }
+
+  // false, если размер не совпадает с SIZE
+  static bool decode(const void* data, size_t size, DeltaHeader& header) {
+    if (size != SIZE) {
+      return false;
+    }
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint32_t* fields[] = {&header.baseId, &header.id, &header.recordCount};
+    for (uint32_t* field : fields) {
+      *field = static_cast<uint32_t>(bytes[0]) |
+               (static_cast<uint32_t>(bytes[1]) << 8) |
+               (static_cast<uint32_t>(bytes[2]) << 16) |
+               (static_cast<uint32_t>(bytes[3]) << 24);
+      bytes += 4;
+    }
+    return true;
+  }
+};
+
+// Ключ разбиения публикации на шарды
+enum class ShardKey { None, LastNameInitial, BirthYear, IdRange };
+
+// Схема шардов: ключ и (для IdRange) ширина диапазона ID. Имя шарда —
+// первая буква фамилии (символ UTF-8), год рождения или начало диапазона,
+// в который попадает первый ID студента (первый ID не меняется при
+// объединении дубликатов)
+struct ShardScheme {
+  static constexpr uint32_t DEFAULT_ID_RANGE = 1000;
+
+  ShardKey key = ShardKey::None;
+  uint32_t idRange = DEFAULT_ID_RANGE;
+
+  bool enabled() const { return key != ShardKey::None; }
+
+  bool operator==(const ShardScheme& other) const {
+    return key == other.key &&
+           (key != ShardKey::IdRange || idRange == other.idRange);
+  }
+  bool operator!=(const ShardScheme& other) const { return !(*this == other); }
+
+  std::string shardOf(std::string_view lastName, int firstId,
+                      const Date& birthDate) const {
+    switch (key) {
+      case ShardKey::LastNameInitial:
+        return std::string(lastName.substr(0, utf8Length(lastName)));
+      case ShardKey::BirthYear:
+        return std::to_string(birthDate.year);
+      case ShardKey::IdRange: {
+        uint32_t width = idRange > 0 ? idRange : 1;
+        return std::to_string(static_cast<uint32_t>(firstId) / width * width);
+      }
+      default:
+        return "";
+    }
+  }
+
+  std::string shardOf(const Student& student) const {
+    return shardOf(student.lastName, student.ids.empty() ? 0 : student.ids[0],
+                   student.birthDate);
+  }
+
+  std::string shardOf(const StudentView& student) const {
+    return shardOf(student.lastName, student.idCount == 0 ? 0 : student.ids[0],
+                   student.birthDate);
+  }
+
+  // "<ключ> <ширина диапазона>", например "year 1000"
+  std::string encode() const {
+    return std::string(keyName(key)) + ' ' + std::to_string(idRange);
+  }
+
+  static bool parse(std::string_view text, ShardScheme& scheme) {
+    std::istringstream input{std::string(text)};
+    std::string name;
+    input >> name >> scheme.idRange;
+    for (ShardKey key : {ShardKey::None, ShardKey::LastNameInitial,
+                         ShardKey::BirthYear, ShardKey::IdRange}) {
+      if (name == keyName(key)) {
+        scheme.key = key;
+        return !input.fail();
+      }
+    }
+    return false;
+  }
+
+  // Схема из параметра командной строки "<ключ>[:<ширина>]", например
+  // "year" или "id:500"
+  static bool fromOption(std::string_view option, ShardScheme& scheme) {
+    std::string text(option);
+    size_t colon = text.find(':');
+    if (colon == std::string::npos) {
+      text += ' ' + std::to_string(DEFAULT_ID_RANGE);
+    } else {
+      text[colon] = ' ';
+    }
+    return parse(text, scheme) && scheme.enabled();
+  }
+
+  static const char* keyName(ShardKey key) {
+    switch (key) {
+      case ShardKey::LastNameInitial:
+        return "initial";
+      case ShardKey::BirthYear:
+        return "year";
+      case ShardKey::IdRange:
+        return "id";
+      default:
+        return "none";
+    }
+  }
+
+ private:
+  // Длина первого символа UTF-8 (1 для пустой строки и неверного байта)
+  static size_t utf8Length(std::string_view text) {
+    if (text.empty()) return 0;
+    unsigned char lead = static_cast<unsigned char>(text[0]);
+    size_t length = lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 1;
+    return std::min(length, text.size());
+  }
+};
+
+// Топик шарда
+inline std::string shardTopic(std::string_view shard) {
+  std::string topic(SHARD_TOPIC);
+  topic += '/';
+  topic.append(shard.data(), shard.size());
+  topic += '/';
+  return topic;
+}
+
+// Состав шардовой публикации: схема и для каждого шарда номер первого
+// пакета, число пакетов и записей. Пакеты шарда идут подряд, пакет
+// содержит записи одного шарда. Текст: первая строка — "<публикация>
+// <ключ> <ширина диапазона>", затем по строке "<шард> <первый пакет>
+// <пакетов> <записей>"
+struct ShardManifest {
+  struct Shard {
+    std::string name;
+    uint32_t firstBatch = 0;
+    uint32_t batchCount = 0;
+    uint32_t recordCount = 0;
+  };
+
+  uint32_t streamId = 0;
+  ShardScheme scheme;
+  std::vector<Shard> shards;
+
+  std::string encode() const {
+    std::ostringstream output;
+    output << streamId << ' ' << scheme.encode() << '\n';
+    for (const auto& shard : shards) {
+      output << shard.name << ' ' << shard.firstBatch << ' '
+             << shard.batchCount << ' ' << shard.recordCount << '\n';
+    }
+    return output.str();
+  }
+
+  static bool decode(std::string_view text, ShardManifest& manifest) {
+    std::istringstream input{std::string(text)};
+    std::string line;
+    if (!std::getline(input, line)) {
+      return false;
+    }
+    std::istringstream header(line);
+    std::string scheme;
+    if (!(header >> manifest.streamId) || !std::getline(header, scheme) ||
+        !ShardScheme::parse(scheme, manifest.scheme)) {
+      return false;
+    }
+
+    manifest.shards.clear();
+    while (std::getline(input, line)) {
+      std::istringstream fields(line);
+      Shard shard;
+      if (!(fields >> shard.name >> shard.firstBatch >> shard.batchCount >>
+            shard.recordCount)) {
+        return false;
+      }
+      manifest.shards.push_back(std::move(shard));
+    }
+    return true;
+  }
+};
+
+// Сервис снимков (ROUTER у publisher) для подписчиков, подключившихся
+// после начала публикации. Запрос: "SNAPSHOT" (текст) или "SNAPSHOT BIN";
+// подписчик шардов добавляет перед форматом " SHARDS <ключ> <ширина>
+// <шард>,<шард>,...," (список всегда заканчивается запятой) и получает
+// только эти шарды, если схема совпадает со схемой publisher. Ответ из
+// трех частей: "OK" или "OK BIN", номер публикации (десятичный) и список в
+// этом формате
+inline constexpr std::string_view SNAPSHOT = "SNAPSHOT";
+inline constexpr std::string_view SHARDS = " SHARDS ";
+
+// Снимок выдается одним сообщением, поэтому поток заменяется двоичным
+// форматом
+inline std::string snapshotRequest(
+    WireFormat format, const ShardScheme& scheme = ShardScheme(),
+    const std::vector<std::string>& shards = {}) {
+  std::string request(SNAPSHOT);
+  if (scheme.enabled()) {
+    request.append(SHARDS).append(scheme.encode()).append(" ");
+    for (const auto& shard : shards) {
+      request.append(shard).append(",");
+    }
+    if (shards.empty()) {
+      request.append(",");
+    }
+  }
+  return withFormat(request, format == WireFormat::Text ? WireFormat::Text
+                                                        : WireFormat::Binary);
+}
+
+// Шарды из запроса снимка; false, если запрос не ограничен шардами
+inline bool parseSnapshotShards(std::string_view request, ShardScheme& scheme,
+                                std::vector<std::string>& shards) {
+  size_t start = request.find(SHARDS);
+  if (start == std::string_view::npos) {
+    return false;
+  }
+
+  std::istringstream input{std::string(request.substr(start + SHARDS.size()))};
+  std::string key;
+  std::string range;
+  std::string list;
+  input >> key >> range >> list;
+  if (input.fail() || list.find(',') == std::string::npos ||
+      !ShardScheme::parse(key + ' ' + range, scheme)) {
+    return false;
+  }
+
+  shards.clear();
+  std::istringstream names(list);
+  std::string name;
+  while (std::getline(names, name, ',')) {
+    if (!name.empty()) {
+      shards.push_back(name);
+    }
+  }
+  return true;
+}
+
+// Канал восстановления потоковой публикации (подписчик DEALER — publisher
+// ROUTER). Подписчик запрашивает пропущенные пакеты "NACK <публикация>
+// <первый> <последний>" и получает их в ответ (BatchHeader и записи), а
+// собрав публикацию, подтверждает прием "DONE <публикация>"
+inline constexpr std::string_view NACK = "NACK";
+inline constexpr std::string_view DONE = "DONE";
+
+struct RepairRequest {
+  bool done = false;
+  uint32_t streamId = 0;
+  uint32_t first = 0;
+  uint32_t last = 0;
+};
+
+inline std::string nackMessage(uint32_t streamId, uint32_t first,
+                               uint32_t last) {
+  std::ostringstream message;
+  message << NACK << ' ' << streamId << ' ' << first << ' ' << last;
+  return message.str();
+}
+
+inline std::string doneMessage(uint32_t streamId) {
+  std::ostringstream message;
+  message << DONE << ' ' << streamId;
+  return message.str();
+}
+
+// false, если сообщение не NACK и не DONE или повреждено
+inline bool parseRepairRequest(std::string_view message,
+                               RepairRequest& request) {
+  std::istringstream input{std::string(message)};
+  std::string kind;
+  input >> kind >> request.streamId;
+  request.done = kind == DONE;
+  if (!request.done) {
+    input >> request.first >> request.last;
+  }
+  return !input.fail() && (request.done || kind == NACK) &&
+         request.first <= request.last;
+}
+
+// Сервис запросов (ROUTER у сервера, клиент REQ): поиск отдельных
+// студентов без приема всего списка. Запросы:
+// - "QUERY ID <id>" — студент с этим ID (у объединенной записи их
+//   несколько; ID, повторенный во входных файлах у разных студентов,
+//   находит всех);
+// - "QUERY NAME <начало ФИО>" — студенты, строка ФИО которых ("Имя
+//   Отчество Фамилия") начинается с этой строки (остаток запроса, может
+//   содержать пробелы);
+// - "QUERY DATES <ДД.ММ.ГГГГ> <ДД.ММ.ГГГГ>" — родившиеся в этом диапазоне
+//   (обе даты включительно).
+// Ответ из двух частей: "OK <найдено>" и найденные записи в двоичном
+// формате (не больше QUERY_LIMIT: по ФИО или по дате рождения), либо
+// "ERROR <причина>" и пустая часть
+inline constexpr std::string_view QUERY = "QUERY";
+inline constexpr std::string_view QUERY_ERROR = "ERROR";
+inline constexpr size_t QUERY_LIMIT = 1000;
+
+enum class QueryKind { Id, Name, Dates };
+
+struct Query {
+  QueryKind kind = QueryKind::Id;
+  int id = 0;
+  std::string namePrefix;
+  Date from{};
+  Date to{};
+};
+
+inline std::string queryRequest(const Query& query) {
+  std::string request(QUERY);
+  switch (query.kind) {
+    case QueryKind::Id:
+      request.append(" ID ").append(std::to_string(query.id));
+      break;
+    case QueryKind::Name:
+      request.append(" NAME ").append(query.namePrefix);
+      break;
+    case QueryKind::Dates:
+      request.append(" DATES ")
+          .append(query.from.toString())
+          .append(" ")
+          .append(query.to.toString());
+      break;
+  }
+  return request;
+}
+
+// false, если запрос не QUERY или поврежден
+inline bool parseQuery(std::string_view message, Query& query) {
+  std::istringstream input{std::string(message)};
+  std::string kind;
+  std::string type;
+  input >> kind >> type;
+  if (input.fail() || kind != QUERY) {
+    return false;
+  }
+
+  if (type == "ID") {
+    query.kind = QueryKind::Id;
+    input >> query.id;
+    return !input.fail();
+  }
+  if (type == "NAME") {
+    query.kind = QueryKind::Name;
+    size_t start = message.find(" NAME ");
+    query.namePrefix = start == std::string_view::npos
+                           ? std::string()
+                           : std::string(message.substr(start + 6));
+    return !query.namePrefix.empty();
+  }
+  if (type == "DATES") {
+    query.kind = QueryKind::Dates;
+    std::string from;
+    std::string to;
+    input >> from >> to;
+    return !input.fail() && Validator::tryParseDate(from, query.from) &&
+           Validator::tryParseDate(to, query.to);
+  }
+  return false;
+}
+
+}  // namespace protocol
\ No newline at end of file
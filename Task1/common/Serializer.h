@@ -1,14 +1,33 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <memory>
 #include <sstream>
+#include <string>
+#include <string_view>
 #include <vector>
 
 #include "Student.h"
+#include "StudentTable.h"
 #include "Validator.h"
 
 class Serializer {
  public:
+  // Двоичный формат (числа фиксированной длины — little-endian):
+  //   заголовок (12 байт): MAGIC "STUB", версия u8, флаги u8, резерв u16,
+  //     число записей u32
+  //   запись: число ID и ID (varint), имя, отчество и фамилия (длина varint
+  //     и байты), дата (Date::pack, u32)
+  static constexpr char BINARY_MAGIC[4] = {'S', 'T', 'U', 'B'};
+  static constexpr uint8_t BINARY_VERSION = 1;
+  static constexpr size_t BINARY_HEADER_SIZE = 12;
+  // Записи уже прошли валидацию у отправителя
+  static constexpr uint8_t FLAG_VALIDATED = 1;
+
   // Сериализация списка студентов в строку
   // Формат: каждый студент на отдельной строке
   // ID1,ID2,ID3|FirstName|MiddleName|LastName|DD.MM.YYYY
@@ -38,6 +57,170 @@ class Serializer {
     return oss.str();
   }
 
+  // Сериализация таблицы в тот же текстовый формат
+  static std::string serialize(const StudentTable& students) {
+    std::string data;
+    data.reserve(students.size() * 48);
+
+    for (size_t row = 0; row < students.size(); ++row) {
+      StudentTable::IdRange ids = students.ids(row);
+      for (size_t i = 0; i < ids.size(); ++i) {
+        data += std::to_string(ids[i]);
+        if (i < ids.size() - 1) {
+          data += ',';
+        }
+      }
+      data += '|';
+
+      data.append(students.firstName(row)).append("|");
+      data.append(students.middleName(row)).append("|");
+      data.append(students.lastName(row)).append("|");
+
+      data += students.birthDate(row).toString();
+      data += '\n';
+    }
+
+    return data;
+  }
+
+  // Сериализация в двоичный формат. validated — записи уже проверены,
+  // получатель может не проверять их повторно
+  static std::string serializeBinary(const std::vector<Student>& students,
+                                     bool validated = true) {
+    return serializeBinary(students, 0, students.size(), validated);
+  }
+
+  // Сериализация студентов [first, last) — один пакет потоковой публикации
+  static std::string serializeBinary(const std::vector<Student>& students,
+                                     size_t first, size_t last,
+                                     bool validated = true) {
+    std::string data;
+    data.reserve(BINARY_HEADER_SIZE + (last - first) * 32);
+    writeHeader(data, last - first, validated);
+
+    for (size_t i = first; i < last; ++i) {
+      const Student& student = students[i];
+      writeRecord(data, student.ids.data(), student.ids.size(),
+                  student.firstName, student.middleName, student.lastName,
+                  student.birthDate.pack());
+    }
+
+    return data;
+  }
+
+  // Сериализация студентов с номерами rows[0..count) — пакет или снимок
+  // шардовой публикации
+  static std::string serializeBinaryRows(const std::vector<Student>& students,
+                                         const uint32_t* rows, size_t count,
+                                         bool validated = true) {
+    std::string data;
+    data.reserve(BINARY_HEADER_SIZE + count * 32);
+    writeHeader(data, count, validated);
+
+    for (size_t i = 0; i < count; ++i) {
+      const Student& student = students[rows[i]];
+      writeRecord(data, student.ids.data(), student.ids.size(),
+                  student.firstName, student.middleName, student.lastName,
+                  student.birthDate.pack());
+    }
+
+    return data;
+  }
+
+  static std::string serializeBinary(const StudentTable& students,
+                                     bool validated = true) {
+    std::string data;
+    data.reserve(BINARY_HEADER_SIZE + students.size() * 32);
+    writeHeader(data, students.size(), validated);
+
+    for (size_t row = 0; row < students.size(); ++row) {
+      StudentTable::IdRange ids = students.ids(row);
+      writeRecord(data, ids.begin(), ids.size(), students.firstName(row),
+                  students.middleName(row), students.lastName(row),
+                  students.packedDate(row));
+    }
+
+    return data;
+  }
+
+  // Начинаются ли данные с заголовка двоичного формата
+  static bool isBinary(const void* data, size_t size) {
+    return size >= sizeof(BINARY_MAGIC) &&
+           std::memcmp(data, BINARY_MAGIC, sizeof(BINARY_MAGIC)) == 0;
+  }
+
+  // Десериализация двоичного формата. Если отправитель не пометил данные
+  // как проверенные, каждая запись проходит валидацию
+  static std::vector<Student> deserializeBinary(const void* data,
+                                                size_t size) {
+    std::vector<StudentView> views;
+    std::vector<int> ids;
+    deserializeBinaryViews(data, size, views, ids);
+
+    std::vector<Student> students;
+    students.reserve(views.size());
+    for (const auto& view : views) {
+      students.push_back(view.materialize());
+    }
+    return students;
+  }
+
+  // Разбор двоичных данных без копирования имен: имена views ссылаются на
+  // data, ID складываются в ids, на который ссылаются views (ids нельзя
+  // изменять, пока используются views). Проверки и сообщения — как у
+  // deserializeBinary
+  static void deserializeBinaryViews(const void* data, size_t size,
+                                     std::vector<StudentView>& views,
+                                     std::vector<int>& ids) {
+    views.clear();
+    ids.clear();
+    BinaryReader reader{static_cast<const uint8_t*>(data),
+                        static_cast<const uint8_t*>(data) + size};
+
+    uint32_t count = 0;
+    bool validated = false;
+    if (!readHeader(reader, count, validated)) {
+      return;
+    }
+
+    size_t maxRecords = std::min<size_t>(count, size / MIN_RECORD_SIZE);
+    views.reserve(maxRecords);
+    ids.reserve(maxRecords);
+
+    // Пока ids растет, вместо указателя запоминается смещение
+    std::vector<size_t> idStarts;
+    idStarts.reserve(maxRecords);
+
+    for (uint32_t i = 0; i < count; ++i) {
+      StudentView view;
+      size_t idStart = ids.size();
+      if (!readRecord(reader, view, ids)) {
+        std::cerr << "⚠️  Десериализация: повреждена запись " << i + 1
+                  << std::endl;
+        ids.resize(idStart);
+        break;
+      }
+
+      view.ids = ids.data() + idStart;
+      if (validated || Validator::validateStudent(view)) {
+        views.push_back(view);
+        idStarts.push_back(idStart);
+      } else {
+        std::cerr << "⚠️  Десериализация: запись " << i + 1
+                  << " не прошла валидацию" << std::endl;
+        ids.resize(idStart);
+      }
+    }
+
+    for (size_t i = 0; i < views.size(); ++i) {
+      views[i].ids = ids.data() + idStarts[i];
+    }
+  }
+
+  static std::vector<Student> deserializeBinary(const std::string& data) {
+    return deserializeBinary(data.data(), data.size());
+  }
+
   // Десериализация строки в список студентов
   static std::vector<Student> deserialize(const std::string& data) {
     std::vector<Student> students;
@@ -66,7 +249,171 @@ class Serializer {
     return students;
   }
 
+  // Десериализация сразу в таблицу (имена интернируются в pool или в новый
+  // пул). Проверки и сообщения — как у deserialize
+  static StudentTable deserializeTable(
+      const std::string& data, std::shared_ptr<StringPool> pool = nullptr) {
+    StudentTable students(std::move(pool));
+    std::istringstream iss(data);
+    std::string line;
+    int lineNumber = 0;
+
+    while (std::getline(iss, line)) {
+      lineNumber++;
+      if (line.empty()) continue;
+
+      Student student;
+      if (deserializeLine(line, student)) {
+        if (Validator::validateStudent(student)) {
+          students.add(student);
+        } else {
+          std::cerr << "⚠️  Десериализация: строка " << lineNumber
+                    << " не прошла валидацию" << std::endl;
+        }
+      } else {
+        std::cerr << "⚠️  Десериализация: ошибка парсинга строки " << lineNumber
+                  << std::endl;
+      }
+    }
+
+    return students;
+  }
+
  private:
+  // Минимальный размер записи: число ID, один ID, три длины и дата
+  static constexpr size_t MIN_RECORD_SIZE = 9;
+
+  struct BinaryReader {
+    const uint8_t* pos;
+    const uint8_t* end;
+
+    bool readVarint(uint64_t& value) {
+      value = 0;
+      for (int shift = 0; shift < 64 && pos < end; shift += 7) {
+        uint8_t byte = *pos++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    bool readU32(uint32_t& value) {
+      if (end - pos < 4) {
+        return false;
+      }
+      value = static_cast<uint32_t>(pos[0]) |
+              (static_cast<uint32_t>(pos[1]) << 8) |
+              (static_cast<uint32_t>(pos[2]) << 16) |
+              (static_cast<uint32_t>(pos[3]) << 24);
+      pos += 4;
+      return true;
+    }
+
+    bool readString(std::string_view& value) {
+      uint64_t length;
+      if (!readVarint(length) ||
+          length > static_cast<uint64_t>(end - pos)) {
+        return false;
+      }
+      value = std::string_view(reinterpret_cast<const char*>(pos), length);
+      pos += length;
+      return true;
+    }
+  };
+
+  static void writeVarint(std::string& data, uint64_t value) {
+    while (value >= 0x80) {
+      data += static_cast<char>((value & 0x7F) | 0x80);
+      value >>= 7;
+    }
+    data += static_cast<char>(value);
+  }
+
+  static void writeU32(std::string& data, uint32_t value) {
+    data += static_cast<char>(value & 0xFF);
+    data += static_cast<char>((value >> 8) & 0xFF);
+    data += static_cast<char>((value >> 16) & 0xFF);
+    data += static_cast<char>(value >> 24);
+  }
+
+  static void writeString(std::string& data, std::string_view value) {
+    writeVarint(data, value.size());
+    data.append(value.data(), value.size());
+  }
+
+  static void writeHeader(std::string& data, size_t count, bool validated) {
+    data.append(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    data += static_cast<char>(BINARY_VERSION);
+    data += static_cast<char>(validated ? FLAG_VALIDATED : 0);
+    data.append(2, '\0');
+    writeU32(data, static_cast<uint32_t>(count));
+  }
+
+  static void writeRecord(std::string& data, const int* ids, size_t idCount,
+                          std::string_view firstName,
+                          std::string_view middleName,
+                          std::string_view lastName, uint32_t packedDate) {
+    writeVarint(data, idCount);
+    for (size_t i = 0; i < idCount; ++i) {
+      writeVarint(data, static_cast<uint32_t>(ids[i]));
+    }
+    writeString(data, firstName);
+    writeString(data, middleName);
+    writeString(data, lastName);
+    writeU32(data, packedDate);
+  }
+
+  static bool readHeader(BinaryReader& reader, uint32_t& count,
+                         bool& validated) {
+    if (!isBinary(reader.pos, reader.end - reader.pos) ||
+        reader.end - reader.pos < static_cast<ptrdiff_t>(BINARY_HEADER_SIZE)) {
+      std::cerr << "⚠️  Десериализация: неверный заголовок двоичных данных"
+                << std::endl;
+      return false;
+    }
+
+    uint8_t version = reader.pos[4];
+    if (version != BINARY_VERSION) {
+      std::cerr << "⚠️  Десериализация: неподдерживаемая версия формата "
+                << static_cast<int>(version) << std::endl;
+      return false;
+    }
+
+    validated = (reader.pos[5] & FLAG_VALIDATED) != 0;
+    reader.pos += 8;
+    return reader.readU32(count);
+  }
+
+  static bool readRecord(BinaryReader& reader, StudentView& view,
+                         std::vector<int>& ids) {
+    uint64_t idCount;
+    if (!reader.readVarint(idCount) || idCount == 0 ||
+        idCount > static_cast<uint64_t>(reader.end - reader.pos)) {
+      return false;
+    }
+
+    for (uint64_t i = 0; i < idCount; ++i) {
+      uint64_t value;
+      if (!reader.readVarint(value) || value > UINT32_MAX) {
+        return false;
+      }
+      ids.push_back(static_cast<int>(static_cast<uint32_t>(value)));
+    }
+    view.ids = ids.data() + ids.size() - idCount;
+    view.idCount = idCount;
+
+    uint32_t packedDate;
+    if (!reader.readString(view.firstName) ||
+        !reader.readString(view.middleName) ||
+        !reader.readString(view.lastName) || !reader.readU32(packedDate)) {
+      return false;
+    }
+    view.birthDate = Date::unpack(packedDate);
+    return true;
+  }
+
   static bool deserializeLine(const std::string& line, Student& student) {
     std::istringstream iss(line);
     std::string token;
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <utility>
+
+// Сегмент общей памяти POSIX с сериализованными данными (RAII). Publisher
+// записывает данные один раз, подписчики на этой же машине отображают
+// сегмент только для чтения, и по сети уходит только его имя. Сегмент
+// удаляется (shm_unlink) вместе с объектом: уже отображенные копии
+// остаются доступными подписчикам до munmap
+class SharedSegment {
+ public:
+  SharedSegment() = default;
+
+  ~SharedSegment() { remove(); }
+
+  SharedSegment(const SharedSegment&) = delete;
+  SharedSegment& operator=(const SharedSegment&) = delete;
+
+  SharedSegment(SharedSegment&& other) noexcept
+      : name_(std::move(other.name_)), size_(std::exchange(other.size_, 0)) {
+    other.name_.clear();
+  }
+
+  SharedSegment& operator=(SharedSegment&& other) noexcept {
+    if (this != &other) {
+      remove();
+      name_ = std::move(other.name_);
+      size_ = std::exchange(other.size_, 0);
+      other.name_.clear();
+    }
+    return *this;
+  }
+
+  // Создание сегмента name ("/имя") и запись в него size байт data.
+  // Сегмент с тем же именем, оставшийся от прежнего процесса, заменяется.
+  // false — ошибка (errno)
+  bool create(const std::string& name, const void* data, size_t size) {
+    remove();
+    if (size == 0) {
+      errno = EINVAL;
+      return false;
+    }
+
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0 && errno == EEXIST) {
+      shm_unlink(name.c_str());
+      fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    }
+    if (fd < 0) {
+      return false;
+    }
+
+    void* mapped = MAP_FAILED;
+    if (ftruncate(fd, static_cast<off_t>(size)) == 0) {
+      mapped = mmap(nullptr, size, PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    int error = errno;
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+      shm_unlink(name.c_str());
+      errno = error;
+      return false;
+    }
+
+    // Записанные страницы принадлежат сегменту, отображение publisher'у
+    // больше не нужно
+    std::memcpy(mapped, data, size);
+    munmap(mapped, size);
+
+    name_ = name;
+    size_ = size;
+    return true;
+  }
+
+  void remove() {
+    if (!name_.empty()) {
+      shm_unlink(name_.c_str());
+    }
+    name_.clear();
+    size_ = 0;
+  }
+
+  bool isOpen() const { return !name_.empty(); }
+  const std::string& name() const { return name_; }
+  size_t size() const { return size_; }
+
+  // Отображение сегмента name только для чтения; сегмент должен быть не
+  // меньше size байт. nullptr — ошибка (errno). Освобождается unmap()
+  static const void* map(const std::string& name, size_t size) {
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+      return nullptr;
+    }
+
+    struct stat st;
+    void* mapped = MAP_FAILED;
+    if (fstat(fd, &st) == 0) {
+      if (size == 0 || static_cast<size_t>(st.st_size) < size) {
+        errno = EINVAL;
+      } else {
+        mapped = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+      }
+    }
+    int error = errno;
+    ::close(fd);
+    errno = error;
+    return mapped == MAP_FAILED ? nullptr : mapped;
+  }
+
+  static void unmap(const void* data, size_t size) {
+    munmap(const_cast<void*>(data), size);
+  }
+
+ private:
+  std::string name_;
+  size_t size_ = 0;
+};
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <ctime>
 #include <string>
+#include <string_view>
 #include <vector>
 
 struct Date {
@@ -19,6 +23,19 @@ struct Date {
     return day < other.day;
   }
 
+  // Упаковка в одно число: год << 9 | месяц << 5 | день. Для корректных
+  // дат порядок упакованных значений совпадает с operator<
+  uint32_t pack() const {
+    return (static_cast<uint32_t>(year) << 9) |
+           (static_cast<uint32_t>(month) << 5) | static_cast<uint32_t>(day);
+  }
+
+  static Date unpack(uint32_t packed) {
+    return Date{static_cast<int>(packed & 31),
+                static_cast<int>((packed >> 5) & 15),
+                static_cast<int>(packed >> 9)};
+  }
+
   std::string toString() const {
     char buffer[11];
     snprintf(buffer, sizeof(buffer), "%02d.%02d.%04d", day, month, year);
@@ -26,6 +43,95 @@ struct Date {
   }
 };
 
+// ФИО из трех частей, которое сравнивается как строка getFullName() ("Имя
+// Отчество Фамилия"), но без ее построения. Части ссылаются на чужую
+// память
+struct FullNameRef {
+  std::string_view first;
+  std::string_view middle;
+  std::string_view last;
+
+  // Сравнение строк getFullName(): <0, 0 или >0, как у std::string::compare
+  int compare(const FullNameRef& other) const {
+    const std::string_view parts[] = {first, " ", middle, " ", last};
+    const std::string_view otherParts[] = {other.first, " ", other.middle,
+                                           " ", other.last};
+    return compareParts(parts, 5, otherParts, 5);
+  }
+
+  // Сравнение строки getFullName() с готовой строкой (например, с границей
+  // диапазона имен)
+  int compare(std::string_view fullName) const {
+    const std::string_view parts[] = {first, " ", middle, " ", last};
+    return compareParts(parts, 5, &fullName, 1);
+  }
+
+  // Начинается ли строка getFullName() с prefix
+  bool startsWith(std::string_view prefix) const {
+    const std::string_view parts[] = {first, " ", middle, " ", last};
+    for (std::string_view part : parts) {
+      size_t length = std::min(part.size(), prefix.size());
+      if (part.substr(0, length) != prefix.substr(0, length)) {
+        return false;
+      }
+      prefix.remove_prefix(length);
+    }
+    return prefix.empty();
+  }
+
+  // Первые PREFIX_BYTES байт строки getFullName() одним числом (первый байт
+  // — старший, недостающие байты — нули). Если префиксы различны, их
+  // порядок совпадает с compare; равные префиксы сравниваются compare
+  static constexpr int PREFIX_BYTES = 8;
+
+  uint64_t prefix() const {
+    const std::string_view parts[] = {first, " ", middle, " ", last};
+    uint64_t result = 0;
+    int filled = 0;
+    for (std::string_view part : parts) {
+      for (size_t i = 0; i < part.size() && filled < PREFIX_BYTES; ++i) {
+        result = (result << 8) | static_cast<unsigned char>(part[i]);
+        filled++;
+      }
+    }
+    return filled == 0 ? 0 : result << (8 * (PREFIX_BYTES - filled));
+  }
+
+ private:
+  // Сравнение двух строк, заданных последовательностями частей
+  static int compareParts(const std::string_view* parts, size_t count,
+                          const std::string_view* otherParts,
+                          size_t otherCount) {
+    size_t part = 0, offset = 0;
+    size_t otherPart = 0, otherOffset = 0;
+    while (true) {
+      while (part < count && offset == parts[part].size()) {
+        part++;
+        offset = 0;
+      }
+      while (otherPart < otherCount &&
+             otherOffset == otherParts[otherPart].size()) {
+        otherPart++;
+        otherOffset = 0;
+      }
+      if (part == count || otherPart == otherCount) {
+        return (part == count ? 0 : 1) - (otherPart == otherCount ? 0 : 1);
+      }
+
+      size_t length = std::min(parts[part].size() - offset,
+                               otherParts[otherPart].size() - otherOffset);
+      int result = std::memcmp(parts[part].data() + offset,
+                               otherParts[otherPart].data() + otherOffset,
+                               length);
+      if (result != 0) {
+        return result;
+      }
+      offset += length;
+      otherOffset += length;
+    }
+  }
+};
+
 struct Student {
   std::vector<int> ids;  // Может быть несколько ID для одного студента
   std::string firstName;
@@ -43,8 +149,13 @@ struct Student {
     return getFullName() + "_" + birthDate.toString();
   }
 
+  FullNameRef fullNameRef() const {
+    return FullNameRef{firstName, middleName, lastName};
+  }
+
+  // Порядок строк getFullName() без их построения
   bool operator<(const Student& other) const {
-    return getFullName() < other.getFullName();
+    return fullNameRef().compare(other.fullNameRef()) < 0;
   }
 
   std::string toString() const {
@@ -57,4 +168,74 @@ struct Student {
 
     return idsStr + " " + getFullName() + " " + birthDate.toString();
   }
+};
+
+// Изменения объединенного списка между двумя версиями. Студент
+// определяется ключом объединения (ФИО и дата рождения): измененный
+// студент — тот же ключ с другим набором ID
+struct StudentDelta {
+  std::vector<Student> added;
+  std::vector<Student> updated;  // новое значение целиком
+  std::vector<Student> removed;
+
+  bool empty() const {
+    return added.empty() && updated.empty() && removed.empty();
+  }
+};
+
+// Запись студента, имена которой ссылаются на внешний буфер (например, на
+// отображённый в память файл). Буфер должен жить дольше записи; полноценный
+// Student создаётся только при вызове materialize()
+struct StudentRecordView {
+  int id;
+  std::string_view firstName;
+  std::string_view middleName;
+  std::string_view lastName;
+  Date birthDate;
+
+  Student materialize() const {
+    Student student;
+    student.ids.push_back(id);
+    student.firstName.assign(firstName.data(), firstName.size());
+    student.middleName.assign(middleName.data(), middleName.size());
+    student.lastName.assign(lastName.data(), lastName.size());
+    student.birthDate = birthDate;
+    return student;
+  }
+};
+
+// Студент, поля которого ссылаются на чужую память (например, на принятое
+// сообщение): имена — на байты буфера, ID — на внешний массив. Владелец
+// памяти должен жить дольше представления
+struct StudentView {
+  const int* ids = nullptr;
+  size_t idCount = 0;
+  std::string_view firstName;
+  std::string_view middleName;
+  std::string_view lastName;
+  Date birthDate{};
+
+  std::string getFullName() const {
+    std::string name;
+    name.reserve(firstName.size() + middleName.size() + lastName.size() + 2);
+    name.append(firstName).append(" ").append(middleName).append(" ").append(
+        lastName);
+    return name;
+  }
+
+  FullNameRef fullNameRef() const {
+    return FullNameRef{firstName, middleName, lastName};
+  }
+
+  std::string toString() const { return materialize().toString(); }
+
+  Student materialize() const {
+    Student student;
+    student.ids.assign(ids, ids + idCount);
+    student.firstName.assign(firstName.data(), firstName.size());
+    student.middleName.assign(middleName.data(), middleName.size());
+    student.lastName.assign(lastName.data(), lastName.size());
+    student.birthDate = birthDate;
+    return student;
+  }
 };
\ No newline at end of file
@@ -0,0 +1,281 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Student.h"
+
+// Пул строк: каждая уникальная строка хранится один раз, на нее ссылается
+// 32-битный номер. Байты строк лежат в крупных блоках, поэтому
+// std::string_view на строку пула остается действительным все время жизни
+// пула. Пул не потокобезопасен
+class StringPool {
+ public:
+  StringPool() = default;
+
+  StringPool(const StringPool&) = delete;
+  StringPool& operator=(const StringPool&) = delete;
+
+  // Номер строки; новая строка добавляется в пул
+  uint32_t intern(std::string_view str) {
+    auto it = ids_.find(str);
+    if (it != ids_.end()) {
+      return it->second;
+    }
+
+    std::string_view stored = store(str);
+    uint32_t id = static_cast<uint32_t>(strings_.size());
+    strings_.push_back(stored);
+    ids_.emplace(stored, id);
+    return id;
+  }
+
+  std::string_view get(uint32_t id) const { return strings_[id]; }
+
+  size_t size() const { return strings_.size(); }
+
+  // Память под байты строк и служебные структуры (приблизительно)
+  size_t memoryBytes() const {
+    return blocks_.size() * BLOCK_SIZE + largeBytes_ +
+           strings_.capacity() * sizeof(std::string_view) +
+           ids_.size() * (sizeof(std::string_view) + sizeof(uint32_t) +
+                          2 * sizeof(void*));
+  }
+
+ private:
+  static constexpr size_t BLOCK_SIZE = 64 << 10;
+
+  // Копирование байтов строки в блок. Длинная строка получает свой блок
+  std::string_view store(std::string_view str) {
+    if (str.empty()) {
+      return std::string_view();
+    }
+
+    char* data;
+    if (str.size() > BLOCK_SIZE / 4) {
+      large_.emplace_back(new char[str.size()]);
+      largeBytes_ += str.size();
+      data = large_.back().get();
+    } else {
+      if (str.size() > available_) {
+        blocks_.emplace_back(new char[BLOCK_SIZE]);
+        current_ = blocks_.back().get();
+        available_ = BLOCK_SIZE;
+      }
+      data = current_;
+      current_ += str.size();
+      available_ -= str.size();
+    }
+
+    std::memcpy(data, str.data(), str.size());
+    return std::string_view(data, str.size());
+  }
+
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  std::vector<std::unique_ptr<char[]>> large_;
+  char* current_ = nullptr;
+  size_t available_ = 0;
+  size_t largeBytes_ = 0;
+
+  std::vector<std::string_view> strings_;
+  std::unordered_map<std::string_view, uint32_t> ids_;
+};
+
+// Компактное хранение списка студентов по столбцам (structure of arrays).
+// Имена — номера строк в общем пуле StringPool, дата упакована в одно число
+// (Date::pack), ID всех строк лежат в одном массиве, строка таблицы хранит
+// лишь смещение. Несколько таблиц могут разделять один пул, тогда одинаковые
+// имена в них имеют одинаковые номера
+class StudentTable {
+ public:
+  // ID одной строки таблицы
+  class IdRange {
+   public:
+    IdRange(const int* first, const int* last) : first_(first), last_(last) {}
+
+    const int* begin() const { return first_; }
+    const int* end() const { return last_; }
+    size_t size() const { return static_cast<size_t>(last_ - first_); }
+    int operator[](size_t i) const { return first_[i]; }
+
+   private:
+    const int* first_;
+    const int* last_;
+  };
+
+  explicit StudentTable(std::shared_ptr<StringPool> pool = nullptr)
+      : pool_(pool != nullptr ? std::move(pool)
+                              : std::make_shared<StringPool>()) {}
+
+  size_t size() const { return dates_.size(); }
+  bool empty() const { return dates_.empty(); }
+
+  void reserve(size_t rows, size_t idCount = 0) {
+    firstNames_.reserve(rows);
+    middleNames_.reserve(rows);
+    lastNames_.reserve(rows);
+    dates_.reserve(rows);
+    idOffsets_.reserve(rows + 1);
+    ids_.reserve(idCount > 0 ? idCount : rows);
+  }
+
+  void clear() {
+    firstNames_.clear();
+    middleNames_.clear();
+    lastNames_.clear();
+    dates_.clear();
+    idOffsets_.assign(1, 0);
+    ids_.clear();
+  }
+
+  // Добавление строки с уже интернированными в пул таблицы именами
+  void addRow(uint32_t firstName, uint32_t middleName, uint32_t lastName,
+              uint32_t packedDate, const int* ids, size_t idCount) {
+    firstNames_.push_back(firstName);
+    middleNames_.push_back(middleName);
+    lastNames_.push_back(lastName);
+    dates_.push_back(packedDate);
+    ids_.insert(ids_.end(), ids, ids + idCount);
+    idOffsets_.push_back(static_cast<uint32_t>(ids_.size()));
+  }
+
+  void add(const Student& student) {
+    addRow(pool_->intern(student.firstName), pool_->intern(student.middleName),
+           pool_->intern(student.lastName), student.birthDate.pack(),
+           student.ids.data(), student.ids.size());
+  }
+
+  void add(const StudentRecordView& record) {
+    addRow(pool_->intern(record.firstName), pool_->intern(record.middleName),
+           pool_->intern(record.lastName), record.birthDate.pack(), &record.id,
+           1);
+  }
+
+  // Добавление строки другой таблицы; при другом пуле имена
+  // интернируются заново
+  void add(const StudentTable& other, size_t row) {
+    IdRange rowIds = other.ids(row);
+    if (other.pool_ == pool_) {
+      addRow(other.firstNames_[row], other.middleNames_[row],
+             other.lastNames_[row], other.dates_[row], rowIds.begin(),
+             rowIds.size());
+    } else {
+      addRow(pool_->intern(other.firstName(row)),
+             pool_->intern(other.middleName(row)),
+             pool_->intern(other.lastName(row)), other.dates_[row],
+             rowIds.begin(), rowIds.size());
+    }
+  }
+
+  void append(const StudentTable& other) {
+    reserve(size() + other.size(), ids_.size() + other.ids_.size());
+    for (size_t row = 0; row < other.size(); ++row) {
+      add(other, row);
+    }
+  }
+
+  // Номера имен в пуле
+  uint32_t firstNameId(size_t row) const { return firstNames_[row]; }
+  uint32_t middleNameId(size_t row) const { return middleNames_[row]; }
+  uint32_t lastNameId(size_t row) const { return lastNames_[row]; }
+
+  std::string_view firstName(size_t row) const {
+    return pool_->get(firstNames_[row]);
+  }
+  std::string_view middleName(size_t row) const {
+    return pool_->get(middleNames_[row]);
+  }
+  std::string_view lastName(size_t row) const {
+    return pool_->get(lastNames_[row]);
+  }
+
+  uint32_t packedDate(size_t row) const { return dates_[row]; }
+  Date birthDate(size_t row) const { return Date::unpack(dates_[row]); }
+
+  IdRange ids(size_t row) const {
+    return IdRange(ids_.data() + idOffsets_[row],
+                   ids_.data() + idOffsets_[row + 1]);
+  }
+
+  // Полное имя, как в Student::getFullName
+  std::string fullName(size_t row) const {
+    std::string name;
+    std::string_view first = firstName(row);
+    std::string_view middle = middleName(row);
+    std::string_view last = lastName(row);
+    name.reserve(first.size() + middle.size() + last.size() + 2);
+    name.append(first).append(" ").append(middle).append(" ").append(last);
+    return name;
+  }
+
+  // Строка таблицы в виде Student
+  Student student(size_t row) const {
+    IdRange rowIds = ids(row);
+    Student result;
+    result.ids.assign(rowIds.begin(), rowIds.end());
+    result.firstName.assign(firstName(row));
+    result.middleName.assign(middleName(row));
+    result.lastName.assign(lastName(row));
+    result.birthDate = birthDate(row);
+    return result;
+  }
+
+  const StringPool& pool() const { return *pool_; }
+  const std::shared_ptr<StringPool>& sharedPool() const { return pool_; }
+
+  static StudentTable fromStudents(const std::vector<Student>& students,
+                                   std::shared_ptr<StringPool> pool = nullptr) {
+    StudentTable table(std::move(pool));
+    table.reserve(students.size());
+    for (const auto& student : students) {
+      table.add(student);
+    }
+    return table;
+  }
+
+  std::vector<Student> toStudents() const {
+    std::vector<Student> students;
+    students.reserve(size());
+    for (size_t row = 0; row < size(); ++row) {
+      students.push_back(student(row));
+    }
+    return students;
+  }
+
+  // Таблица со строками в порядке order (номера строк этой таблицы)
+  StudentTable reordered(const std::vector<uint32_t>& order) const {
+    StudentTable table(pool_);
+    table.reserve(order.size(), ids_.size());
+    for (uint32_t row : order) {
+      table.add(*this, row);
+    }
+    return table;
+  }
+
+  // Память столбцов таблицы (без пула)
+  size_t memoryBytes() const {
+    return (firstNames_.capacity() + middleNames_.capacity() +
+            lastNames_.capacity() + dates_.capacity() +
+            idOffsets_.capacity()) *
+               sizeof(uint32_t) +
+           ids_.capacity() * sizeof(int);
+  }
+
+ private:
+  std::shared_ptr<StringPool> pool_;
+
+  std::vector<uint32_t> firstNames_;
+  std::vector<uint32_t> middleNames_;
+  std::vector<uint32_t> lastNames_;
+  std::vector<uint32_t> dates_;
+
+  // ID строки row — ids_[idOffsets_[row]] .. ids_[idOffsets_[row + 1]]
+  std::vector<uint32_t> idOffsets_ = std::vector<uint32_t>(1, 0);
+  std::vector<int> ids_;
+};
\ No newline at end of file
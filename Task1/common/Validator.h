@@ -1,36 +1,91 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <iostream>
-#include <regex>
+#include <ostream>
+#include <string_view>
 
+#include "NameScan.h"
 #include "Student.h"
 
+// Таблицы для валидации, вычисляемые на этапе компиляции
+namespace validator_tables {
+
+inline constexpr int MIN_YEAR = 1900;
+inline constexpr int MAX_YEAR = 2010;
+
+constexpr bool isLeapYear(int year) {
+  return (year % 4 == 0 && year % 100 != 0) || (year % 400 == 0);
+}
+
+// Число дней в месяце: [високосный][месяц], месяцы с 1
+inline constexpr uint8_t DAYS_IN_MONTH[2][13] = {
+    {0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31},
+    {0, 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31}};
+
+constexpr std::array<uint8_t, MAX_YEAR - MIN_YEAR + 1> makeLeapYears() {
+  std::array<uint8_t, MAX_YEAR - MIN_YEAR + 1> table{};
+  for (int year = MIN_YEAR; year <= MAX_YEAR; ++year) {
+    table[year - MIN_YEAR] = isLeapYear(year) ? 1 : 0;
+  }
+  return table;
+}
+
+// Признак високосного года для допустимого диапазона
+inline constexpr std::array<uint8_t, MAX_YEAR - MIN_YEAR + 1> LEAP_YEARS =
+    makeLeapYears();
+
+}  // namespace validator_tables
+
 class Validator {
  public:
+  // Поток для сообщений об ошибках (по умолчанию std::cerr). Рабочий поток
+  // может перенаправить его в свой буфер через ErrorRedirect, чтобы затем
+  // вывести сообщения в исходном порядке
+  static std::ostream& errors() {
+    std::ostream* stream = errorStream();
+    return stream != nullptr ? *stream : std::cerr;
+  }
+
+  // Перенаправление errors() текущего потока на время жизни объекта
+  class ErrorRedirect {
+   public:
+    explicit ErrorRedirect(std::ostream& stream) : previous_(errorStream()) {
+      errorStream() = &stream;
+    }
+    ~ErrorRedirect() { errorStream() = previous_; }
+
+    ErrorRedirect(const ErrorRedirect&) = delete;
+    ErrorRedirect& operator=(const ErrorRedirect&) = delete;
+
+   private:
+    std::ostream* previous_;
+  };
+
+  // Допустимый диапазон годов рождения
+  static constexpr int MIN_YEAR = validator_tables::MIN_YEAR;
+  static constexpr int MAX_YEAR = validator_tables::MAX_YEAR;
+
   // Валидация даты
   static bool isValidDate(int day, int month, int year) {
-    if (year < 1900 || year > 2010) {
-      std::cerr << "⚠️  Ошибка: Год должен быть между 1900 и 2010 (получено: "
-                << year << ")" << std::endl;
+    if (year < MIN_YEAR || year > MAX_YEAR) {
+      errors() << "⚠️  Ошибка: Год должен быть между 1900 и 2010 (получено: "
+               << year << ")" << std::endl;
       return false;
     }
 
     if (month < 1 || month > 12) {
-      std::cerr << "⚠️  Ошибка: Месяц должен быть между 1 и 12 (получено: "
-                << month << ")" << std::endl;
+      errors() << "⚠️  Ошибка: Месяц должен быть между 1 и 12 (получено: "
+               << month << ")" << std::endl;
       return false;
     }
 
-    int daysInMonth[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
-
-    // Проверка високосного года
-    if (month == 2 && isLeapYear(year)) {
-      daysInMonth[1] = 29;
-    }
-
-    if (day < 1 || day > daysInMonth[month - 1]) {
-      std::cerr << "⚠️  Ошибка: День " << day << " некорректен для месяца "
-                << month << std::endl;
+    // Число дней в месяце с учетом високосного года
+    int leap = validator_tables::LEAP_YEARS[year - MIN_YEAR];
+    if (day < 1 || day > validator_tables::DAYS_IN_MONTH[leap][month]) {
+      errors() << "⚠️  Ошибка: День " << day << " некорректен для месяца "
+               << month << std::endl;
       return false;
     }
 
@@ -38,17 +93,16 @@ class Validator {
   }
 
   // Валидация имени (только буквы)
-  static bool isValidName(const std::string& name) {
+  static bool isValidName(std::string_view name) {
     if (name.empty()) {
-      std::cerr << "⚠️  Ошибка: Имя не может быть пустым" << std::endl;
+      errors() << "⚠️  Ошибка: Имя не может быть пустым" << std::endl;
       return false;
     }
 
     // Проверка на наличие только букв (латиница и кириллица)
-    std::regex namePattern("^[A-Za-zА-Яа-яЁё]+$");
-    if (!std::regex_match(name, namePattern)) {
-      std::cerr << "⚠️  Ошибка: Имя содержит недопустимые символы: " << name
-                << std::endl;
+    if (!name_scan::allNameBytes(name.data(), name.size())) {
+      errors() << "⚠️  Ошибка: Имя содержит недопустимые символы: " << name
+               << std::endl;
       return false;
     }
 
@@ -58,31 +112,37 @@ class Validator {
   // Валидация ID
   static bool isValidId(int id) {
     if (id <= 0) {
-      std::cerr << "⚠️  Ошибка: ID должен быть положительным числом (получено: "
-                << id << ")" << std::endl;
+      errors() << "⚠️  Ошибка: ID должен быть положительным числом (получено: "
+               << id << ")" << std::endl;
       return false;
     }
     return true;
   }
 
-  // Парсинг даты из строки формата DD.MM.YYYY
-  static bool parseDate(const std::string& dateStr, Date& date) {
-    std::regex datePattern(R"((\d{1,2})\.(\d{1,2})\.(\d{4}))");
-    std::smatch match;
-
-    if (!std::regex_match(dateStr, match, datePattern)) {
-      std::cerr << "⚠️  Ошибка: Неверный формат даты: " << dateStr
-                << " (ожидается DD.MM.YYYY)" << std::endl;
+  // Парсинг даты из строки формата DD.MM.YYYY (день и месяц — 1-2 цифры,
+  // год — ровно 4 цифры)
+  static bool parseDate(std::string_view dateStr, Date& date) {
+    if (!scanDate(dateStr, date)) {
+      errors() << "⚠️  Ошибка: Неверный формат даты: " << dateStr
+               << " (ожидается DD.MM.YYYY)" << std::endl;
       return false;
     }
 
-    date.day = std::stoi(match[1]);
-    date.month = std::stoi(match[2]);
-    date.year = std::stoi(match[3]);
-
     return isValidDate(date.day, date.month, date.year);
   }
 
+  // То же, что parseDate, но без вывода сообщений об ошибках
+  static bool tryParseDate(std::string_view dateStr, Date& date) {
+    if (!scanDate(dateStr, date) || date.year < MIN_YEAR ||
+        date.year > MAX_YEAR || date.month < 1 || date.month > 12) {
+      return false;
+    }
+
+    int leap = validator_tables::LEAP_YEARS[date.year - MIN_YEAR];
+    return date.day >= 1 &&
+           date.day <= validator_tables::DAYS_IN_MONTH[leap][date.month];
+  }
+
   // Валидация всего студента
   static bool validateStudent(const Student& student) {
     if (!isValidId(student.ids[0])) return false;
@@ -94,8 +154,92 @@ class Validator {
                        student.birthDate.year);
   }
 
+  // Пакетная проверка имен записей без вывода сообщений: ok[i] = 1, если
+  // все три имени records[i] непусты и допустимы. Векторное ядро выбирается
+  // один раз на пакет
+  static void validateNames(const StudentRecordView* records, size_t count,
+                            uint8_t* ok) {
+    name_scan::Kernel allNameBytes = name_scan::kernel();
+
+    for (size_t i = 0; i < count; ++i) {
+      const StudentRecordView& record = records[i];
+      ok[i] = !record.firstName.empty() && !record.middleName.empty() &&
+              !record.lastName.empty() &&
+              allNameBytes(record.firstName.data(), record.firstName.size()) &&
+              allNameBytes(record.middleName.data(),
+                           record.middleName.size()) &&
+              allNameBytes(record.lastName.data(), record.lastName.size());
+    }
+  }
+
+  // Валидация студента, ссылающегося на принятые данные
+  static bool validateStudent(const StudentView& student) {
+    if (student.idCount == 0 || !isValidId(student.ids[0])) return false;
+    if (!isValidName(student.firstName)) return false;
+    if (!isValidName(student.middleName)) return false;
+    if (!isValidName(student.lastName)) return false;
+
+    return isValidDate(student.birthDate.day, student.birthDate.month,
+                       student.birthDate.year);
+  }
+
+  // Валидация записи, ссылающейся на буфер файла
+  static bool validateStudent(const StudentRecordView& record) {
+    if (!isValidId(record.id)) return false;
+    if (!isValidName(record.firstName)) return false;
+    if (!isValidName(record.middleName)) return false;
+    if (!isValidName(record.lastName)) return false;
+
+    return isValidDate(record.birthDate.day, record.birthDate.month,
+                       record.birthDate.year);
+  }
+
  private:
-  static bool isLeapYear(int year) {
-    return (year % 4 == 0 && year % 100 != 0) || (year % 400 == 0);
+  static std::ostream*& errorStream() {
+    thread_local std::ostream* stream = nullptr;
+    return stream;
+  }
+
+  static constexpr bool isLeapYear(int year) {
+    return validator_tables::isLeapYear(year);
+  }
+
+  // Разбор DD.MM.YYYY без проверки календарной корректности
+  static bool scanDate(std::string_view dateStr, Date& date) {
+    size_t pos = 0;
+    Date scanned;
+
+    if (!scanNumber(dateStr, pos, 1, 2, scanned.day) ||
+        !scanDot(dateStr, pos) ||
+        !scanNumber(dateStr, pos, 1, 2, scanned.month) ||
+        !scanDot(dateStr, pos) ||
+        !scanNumber(dateStr, pos, 4, 4, scanned.year) ||
+        pos != dateStr.size()) {
+      return false;
+    }
+
+    date = scanned;
+    return true;
+  }
+
+  // Чтение от minDigits до maxDigits десятичных цифр
+  static bool scanNumber(std::string_view str, size_t& pos, size_t minDigits,
+                         size_t maxDigits, int& value) {
+    size_t start = pos;
+    value = 0;
+    while (pos < str.size() && pos - start < maxDigits && str[pos] >= '0' &&
+           str[pos] <= '9') {
+      value = value * 10 + (str[pos] - '0');
+      pos++;
+    }
+    return pos - start >= minDigits;
+  }
+
+  static bool scanDot(std::string_view str, size_t& pos) {
+    if (pos < str.size() && str[pos] == '.') {
+      pos++;
+      return true;
+    }
+    return false;
   }
 };
\ No newline at end of file
@@ -0,0 +1,621 @@
+#pragma once
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "../common/Student.h"
+#include "FileParser.h"
+#include "MergeIndex.h"
+#include "StudentMerger.h"
+
+// Объединение файлов со студентами с ограниченным бюджетом памяти.
+// Пока оценка занятой памяти укладывается в бюджет, записи объединяются в
+// MergeIndex, как в StudentMerger::mergeFiles. При превышении бюджета
+// накопленные студенты и все последующие записи раскладываются по хешу
+// ключа во временные файлы-разделы; каждый раздел объединяется отдельно,
+// затем результаты разделов сливаются по номеру первого появления. Раздел,
+// не помещающийся в бюджет, раскладывается на подразделы по хешу с другим
+// затравочным значением, пока они не поместятся.
+// Результат (состав, ID и порядок) совпадает с объединением в памяти
+class ExternalMerger {
+ public:
+  static constexpr size_t DEFAULT_MEMORY_BUDGET = size_t(256) << 20;
+
+  // Объединение файлов и каталогов: студенты передаются в consume(Student&&)
+  // в порядке первого появления. tempDir — каталог для временных файлов
+  // (по умолчанию системный). Возвращает false при ошибке записи или чтения
+  // временных файлов
+  template <typename Consumer>
+  static bool mergeFiles(const std::vector<std::string>& inputs,
+                         size_t memoryBudget, Consumer consume,
+                         const std::string& tempDir = "") {
+    std::vector<std::string> files = StudentMerger::collectFiles(inputs);
+    Session session(memoryBudget, tempDir, totalSize(files));
+
+    std::cout << "\n🔄 Объединение " << files.size()
+              << " файлов (бюджет памяти: " << (memoryBudget >> 20)
+              << " МБ)..." << std::endl;
+
+    for (const auto& file : files) {
+      FileParser::streamFile(
+          file, session.windowSize(),
+          [&](const std::vector<StudentRecordView>& records,
+              std::string_view window) {
+            return session.add(records, window.size());
+          });
+      if (session.failed()) {
+        return false;
+      }
+    }
+
+    return session.finish(consume);
+  }
+
+  // То же с накоплением результата в векторе. При ошибке временных файлов
+  // (сообщение уже выведено) возвращается пустой список, а не его часть
+  static std::vector<Student> mergeFiles(
+      const std::vector<std::string>& inputs,
+      size_t memoryBudget = DEFAULT_MEMORY_BUDGET,
+      const std::string& tempDir = "") {
+    std::vector<Student> mergedList;
+    bool merged = mergeFiles(
+        inputs, memoryBudget,
+        [&](Student&& student) { mergedList.push_back(std::move(student)); },
+        tempDir);
+    if (!merged) {
+      std::vector<Student>().swap(mergedList);
+    }
+    return mergedList;
+  }
+
+ private:
+  // Буфер каждого временного файла
+  static constexpr size_t IO_BUFFER_SIZE = 64 << 10;
+  static constexpr size_t MAX_PARTITIONS = 256;
+  // Глубина разбиения раздела на подразделы. Записи с одним ключом всегда
+  // попадают в один подраздел, поэтому раздел из одного студента с
+  // множеством ID не делится — на этой глубине он объединяется как есть
+  static constexpr unsigned MAX_SPLIT_LEVEL = 4;
+  // Запас на строки и ID добавляемого студента
+  static constexpr size_t STUDENT_HEAP_RESERVE = 1024;
+
+  // Запись временного файла: номер первого появления и студент
+  struct RunEntry {
+    uint64_t seq = 0;
+    Student student;
+  };
+
+  // Двоичная запись студентов во временный файл: seq, упакованная дата,
+  // число ID, длины имен, ID, байты имен (порядок байтов — локальный)
+  class RunWriter {
+   public:
+    RunWriter() : buffer_(IO_BUFFER_SIZE) {}
+
+    bool open(const std::string& path) {
+      stream_.rdbuf()->pubsetbuf(buffer_.data(), buffer_.size());
+      stream_.open(path, std::ios::binary | std::ios::trunc);
+      return stream_.is_open();
+    }
+
+    void write(uint64_t seq, const Student& student) {
+      write(seq, student.birthDate.pack(), student.ids.data(),
+            student.ids.size(), student.firstName, student.middleName,
+            student.lastName);
+    }
+
+    void write(uint64_t seq, const StudentRecordView& record) {
+      write(seq, record.birthDate.pack(), &record.id, 1, record.firstName,
+            record.middleName, record.lastName);
+    }
+
+    bool close() {
+      stream_.close();
+      return !stream_.fail();
+    }
+
+   private:
+    void write(uint64_t seq, uint32_t date, const int* ids, size_t idCount,
+               std::string_view firstName, std::string_view middleName,
+               std::string_view lastName) {
+      uint32_t header[5] = {date, static_cast<uint32_t>(idCount),
+                            static_cast<uint32_t>(firstName.size()),
+                            static_cast<uint32_t>(middleName.size()),
+                            static_cast<uint32_t>(lastName.size())};
+      stream_.write(reinterpret_cast<const char*>(&seq), sizeof(seq));
+      stream_.write(reinterpret_cast<const char*>(header), sizeof(header));
+      stream_.write(reinterpret_cast<const char*>(ids),
+                    idCount * sizeof(int));
+      stream_.write(firstName.data(), firstName.size());
+      stream_.write(middleName.data(), middleName.size());
+      stream_.write(lastName.data(), lastName.size());
+    }
+
+    std::vector<char> buffer_;
+    std::ofstream stream_;
+  };
+
+  class RunReader {
+   public:
+    RunReader() : buffer_(IO_BUFFER_SIZE) {}
+
+    bool open(const std::string& path) {
+      stream_.rdbuf()->pubsetbuf(buffer_.data(), buffer_.size());
+      stream_.open(path, std::ios::binary);
+      return stream_.is_open();
+    }
+
+    // Чтение следующей записи; false — конец файла или ошибка
+    bool read(RunEntry& entry) {
+      uint32_t header[5];
+      if (!stream_.read(reinterpret_cast<char*>(&entry.seq),
+                        sizeof(entry.seq)) ||
+          !stream_.read(reinterpret_cast<char*>(header), sizeof(header))) {
+        return false;
+      }
+
+      Student& student = entry.student;
+      student.birthDate = Date::unpack(header[0]);
+      student.ids.resize(header[1]);
+      student.firstName.resize(header[2]);
+      student.middleName.resize(header[3]);
+      student.lastName.resize(header[4]);
+
+      stream_.read(reinterpret_cast<char*>(student.ids.data()),
+                   student.ids.size() * sizeof(int));
+      stream_.read(student.firstName.data(), student.firstName.size());
+      stream_.read(student.middleName.data(), student.middleName.size());
+      stream_.read(student.lastName.data(), student.lastName.size());
+      return static_cast<bool>(stream_);
+    }
+
+    // Файл прочитан целиком без ошибок
+    bool atEnd() const { return stream_.eof(); }
+
+    void close() { stream_.close(); }
+
+    // Прочитано байт с начала файла
+    uint64_t position() {
+      std::streamoff offset = stream_.tellg();
+      return offset < 0 ? 0 : static_cast<uint64_t>(offset);
+    }
+
+   private:
+    std::vector<char> buffer_;
+    std::ifstream stream_;
+  };
+
+  // Каталог временных файлов, удаляемый вместе с содержимым
+  class TempDirectory {
+   public:
+    TempDirectory() = default;
+    ~TempDirectory() {
+      if (!path_.empty()) {
+        std::error_code error;
+        std::filesystem::remove_all(path_, error);
+      }
+    }
+
+    TempDirectory(const TempDirectory&) = delete;
+    TempDirectory& operator=(const TempDirectory&) = delete;
+
+    bool create(const std::string& base) {
+      std::error_code error;
+      std::filesystem::path root =
+          base.empty() ? std::filesystem::temp_directory_path(error)
+                       : std::filesystem::path(base);
+      if (error) {
+        return false;
+      }
+
+      static unsigned counter = 0;
+      for (int attempt = 0; attempt < 100; ++attempt) {
+        std::filesystem::path path =
+            root / ("student_merge_" + std::to_string(getpid()) + "_" +
+                    std::to_string(counter++));
+        if (std::filesystem::create_directory(path, error)) {
+          path_ = path;
+          return true;
+        }
+      }
+      return false;
+    }
+
+    std::string file(const std::string& name) const {
+      return (path_ / name).string();
+    }
+
+   private:
+    std::filesystem::path path_;
+  };
+
+  // Состояние одного объединения
+  class Session {
+   public:
+    Session(size_t memoryBudget, const std::string& tempDir,
+            uint64_t inputBytes)
+        : budget_(std::max<size_t>(memoryBudget, 1)),
+          tempDir_(tempDir),
+          inputBytes_(inputBytes) {}
+
+    // Размер окна разбора входного файла: записи окна тоже занимают память
+    size_t windowSize() const {
+      return std::clamp<size_t>(budget_ / 8, 64 << 10, 8 << 20);
+    }
+
+    bool failed() const { return failed_; }
+
+    bool add(const std::vector<StudentRecordView>& records,
+             size_t windowBytes) {
+      readBytes_ += windowBytes;
+      for (const auto& record : records) {
+        if (partitions_.empty() &&
+            insertBytes(index_, firstSeen_, heapBytes_) > budget_ &&
+            !spill()) {
+          return false;
+        }
+
+        if (partitions_.empty()) {
+          if (index_.add(record)) {
+            heapBytes_ += sizeof(int);
+          } else {
+            firstSeen_.push_back(seq_);
+            heapBytes_ += studentHeapBytes(index_.students().back());
+          }
+        } else {
+          uint64_t hash =
+              MergeIndex::hashKey(record.firstName, record.middleName,
+                                  record.lastName, record.birthDate.pack());
+          partitions_[partitionOf(hash, partitions_.size(), 0)].write(seq_,
+                                                                     record);
+        }
+        seq_++;
+      }
+      return true;
+    }
+
+    template <typename Consumer>
+    bool finish(Consumer& consume) {
+      if (partitions_.empty()) {
+        size_t duplicatesFound = index_.duplicates();
+        std::vector<Student> students = index_.takeStudents();
+        printSummary(students.size(), duplicatesFound);
+        for (auto& student : students) {
+          consume(std::move(student));
+        }
+        return true;
+      }
+
+      size_t unique = 0;
+      for (size_t p = 0; p < partitions_.size(); ++p) {
+        if (!partitions_[p].close() ||
+            !mergePartition(partitionPath(p), 0, unique)) {
+          return fail("Сбой записи или чтения временных файлов");
+        }
+      }
+      partitions_.clear();
+
+      printSummary(unique, seq_ - unique);
+      return mergeRuns(consume);
+    }
+
+   private:
+    // Размер блока в куче с учетом служебных данных распределителя
+    static size_t allocationBytes(size_t size) {
+      return size == 0 ? 0 : std::max<size_t>(32, (size + 8 + 15) & ~15);
+    }
+
+    // Память, которую Student занимает вне своего объекта
+    static size_t studentHeapBytes(const Student& student) {
+      return allocationBytes(student.ids.capacity() * sizeof(int)) +
+             stringBytes(student.firstName) + stringBytes(student.middleName) +
+             stringBytes(student.lastName);
+    }
+
+    static size_t stringBytes(const std::string& str) {
+      return str.capacity() > std::string().capacity()
+                 ? allocationBytes(str.capacity() + 1)
+                 : 0;
+    }
+
+    // Оценка пиковой памяти при добавлении еще одного студента в индекс
+    static size_t insertBytes(const MergeIndex& index,
+                              const std::vector<uint64_t>& firstSeen,
+                              size_t heapBytes) {
+      size_t seenBytes = firstSeen.capacity() * sizeof(uint64_t);
+      if (firstSeen.size() == firstSeen.capacity()) {
+        seenBytes += std::max<size_t>(firstSeen.capacity() * 2, 1) *
+                     sizeof(uint64_t);
+      }
+      return index.tableBytesOnInsert() + seenBytes + heapBytes +
+             STUDENT_HEAP_RESERVE;
+    }
+
+    static size_t usedBytes(const MergeIndex& index,
+                            const std::vector<uint64_t>& firstSeen,
+                            size_t heapBytes) {
+      return index.tableBytes() + firstSeen.capacity() * sizeof(uint64_t) +
+             heapBytes;
+    }
+
+    // Раздел из count для ключа с хешем hash. Уровень level — глубина
+    // разбиения: на каждом уровне хеш перемешивается со своим затравочным
+    // значением, иначе записи одного раздела снова попали бы в один
+    // подраздел
+    static size_t partitionOf(uint64_t hash, size_t count, unsigned level) {
+      if (level > 0) {
+        hash ^= level * 0x9E3779B97F4A7C15ULL;
+        hash ^= hash >> 31;
+        hash *= 0xBF58476D1CE4E5B9ULL;
+        hash ^= hash >> 29;
+      }
+      return ((hash >> 32) * count) >> 32;
+    }
+
+    // Число разделов: прогноз памяти по уже прочитанной доле входных
+    // данных (used байт на readBytes из totalBytes), чтобы раздел занимал
+    // около половины бюджета
+    size_t partitionCount(size_t usedBytes, uint64_t readBytes,
+                          uint64_t totalBytes) const {
+      double used = static_cast<double>(usedBytes);
+      double ratio = used /
+                     static_cast<double>(std::max<uint64_t>(readBytes, 1));
+      uint64_t remaining = totalBytes > readBytes ? totalBytes - readBytes : 0;
+      double expected = used + static_cast<double>(remaining) * ratio;
+      size_t count = static_cast<size_t>(std::ceil(expected / (budget_ / 2.0)));
+
+      size_t maxByBuffers = std::max<size_t>(budget_ / 4 / IO_BUFFER_SIZE, 2);
+      return std::clamp<size_t>(count, 2,
+                                std::min(MAX_PARTITIONS, maxByBuffers));
+    }
+
+    // Переход к работе с временными файлами: накопленные студенты
+    // записываются в разделы вместе с номерами первого появления
+    bool spill() {
+      if (!directory_.create(tempDir_)) {
+        return fail("Не удалось создать каталог для временных файлов");
+      }
+
+      size_t count = partitionCount(
+          usedBytes(index_, firstSeen_, heapBytes_), readBytes_, inputBytes_);
+      std::cout << "💾 Превышен бюджет памяти: запись во временные файлы ("
+                << count << " разделов)" << std::endl;
+
+      partitions_ = std::vector<RunWriter>(count);
+      for (size_t p = 0; p < count; ++p) {
+        if (!partitions_[p].open(partitionPath(p))) {
+          return fail("Не удалось создать временный файл: " +
+                      partitionPath(p));
+        }
+      }
+
+      const std::vector<Student>& students = index_.students();
+      for (size_t i = 0; i < students.size(); ++i) {
+        partitions_[partitionOf(MergeIndex::hashKey(students[i]), count, 0)]
+            .write(firstSeen_[i], students[i]);
+      }
+
+      index_ = MergeIndex();
+      std::vector<uint64_t>().swap(firstSeen_);
+      heapBytes_ = 0;
+      return true;
+    }
+
+    // Объединение раздела path уровня level. Записи раздела идут в порядке
+    // номеров, поэтому студенты индекса раздела тоже упорядочены по первому
+    // появлению и сразу записываются в новый файл результата. Если раздел
+    // не помещается в бюджет, индекс освобождается, и раздел раскладывается
+    // на подразделы следующего уровня
+    bool mergePartition(const std::string& path, unsigned level,
+                        size_t& unique) {
+      RunReader reader;
+      if (!reader.open(path)) {
+        return false;
+      }
+
+      MergeIndex index;
+      std::vector<uint64_t> firstSeen;
+      size_t heapBytes = 0;
+      size_t splitCount = 0;
+      RunEntry entry;
+      while (reader.read(entry)) {
+        if (level < MAX_SPLIT_LEVEL &&
+            insertBytes(index, firstSeen, heapBytes) > budget_) {
+          splitCount =
+              partitionCount(usedBytes(index, firstSeen, heapBytes),
+                             reader.position(), fileSize(path));
+          break;
+        }
+
+        uint64_t seq = entry.seq;
+        if (!index.add(std::move(entry.student))) {
+          firstSeen.push_back(seq);
+          heapBytes += studentHeapBytes(index.students().back());
+        }
+      }
+      if (splitCount > 0) {
+        reader.close();
+        index = MergeIndex();
+        std::vector<uint64_t>().swap(firstSeen);
+        return splitPartition(path, level + 1, splitCount, unique);
+      }
+      if (!reader.atEnd()) {
+        return false;
+      }
+
+      if (level >= MAX_SPLIT_LEVEL &&
+          usedBytes(index, firstSeen, heapBytes) > budget_) {
+        std::cout << "⚠️  Раздел " << path << " превысил бюджет памяти ("
+                  << index.size() << " студентов) и не делится дальше"
+                  << std::endl;
+      }
+
+      RunWriter writer;
+      std::string run = runPath(runs_.size());
+      if (!writer.open(run)) {
+        return false;
+      }
+      runs_.push_back(run);
+      const std::vector<Student>& students = index.students();
+      for (size_t i = 0; i < students.size(); ++i) {
+        writer.write(firstSeen[i], students[i]);
+      }
+      unique += students.size();
+
+      std::error_code error;
+      std::filesystem::remove(path, error);
+      return writer.close();
+    }
+
+    // Раскладка раздела path на count подразделов уровня level (порядок
+    // записей сохраняется) и объединение каждого из них
+    bool splitPartition(const std::string& path, unsigned level, size_t count,
+                        size_t& unique) {
+      std::cout << "💾 Раздел " << path << " не помещается в бюджет памяти: "
+                << count << " подразделов (уровень " << level << ")"
+                << std::endl;
+
+      std::vector<std::string> paths(count);
+      {
+        RunReader reader;
+        std::vector<RunWriter> writers(count);
+        if (!reader.open(path)) {
+          return false;
+        }
+        for (size_t p = 0; p < count; ++p) {
+          paths[p] = path + "_" + std::to_string(p);
+          if (!writers[p].open(paths[p])) {
+            return false;
+          }
+        }
+
+        RunEntry entry;
+        while (reader.read(entry)) {
+          writers[partitionOf(MergeIndex::hashKey(entry.student), count,
+                              level)]
+              .write(entry.seq, entry.student);
+        }
+        if (!reader.atEnd()) {
+          return false;
+        }
+        for (auto& writer : writers) {
+          if (!writer.close()) {
+            return false;
+          }
+        }
+      }
+
+      std::error_code error;
+      std::filesystem::remove(path, error);
+      for (const auto& subpartition : paths) {
+        if (!mergePartition(subpartition, level, unique)) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    // k-way слияние результатов разделов по номеру первого появления
+    template <typename Consumer>
+    bool mergeRuns(Consumer& consume) {
+      size_t count = runs_.size();
+      std::vector<RunReader> readers(count);
+      std::vector<RunEntry> heads(count);
+
+      using HeapItem = std::pair<uint64_t, size_t>;  // номер записи, раздел
+      std::priority_queue<HeapItem, std::vector<HeapItem>, std::greater<>>
+          heap;
+
+      for (size_t p = 0; p < count; ++p) {
+        if (!readers[p].open(runs_[p])) {
+          return fail();
+        }
+        if (readers[p].read(heads[p])) {
+          heap.push({heads[p].seq, p});
+        } else if (!readers[p].atEnd()) {
+          return fail();
+        }
+      }
+
+      while (!heap.empty()) {
+        size_t p = heap.top().second;
+        heap.pop();
+
+        consume(std::move(heads[p].student));
+        if (readers[p].read(heads[p])) {
+          heap.push({heads[p].seq, p});
+        } else if (!readers[p].atEnd()) {
+          return fail();
+        }
+      }
+      return true;
+    }
+
+    bool fail(const std::string& message = "Сбой чтения временных файлов") {
+      std::cerr << "❌ Ошибка: " << message << std::endl;
+      failed_ = true;
+      return false;
+    }
+
+    void printSummary(size_t unique, size_t duplicatesFound) const {
+      std::cout << "✅ Объединение завершено:" << std::endl;
+      std::cout << "   Уникальных студентов: " << unique << std::endl;
+      if (duplicatesFound > 0) {
+        std::cout << "   Найдено дубликатов: " << duplicatesFound << std::endl;
+      }
+    }
+
+    std::string partitionPath(size_t p) const {
+      return directory_.file("partition_" + std::to_string(p));
+    }
+
+    std::string runPath(size_t p) const {
+      return directory_.file("run_" + std::to_string(p));
+    }
+
+    static uint64_t fileSize(const std::string& path) {
+      std::error_code error;
+      uintmax_t size = std::filesystem::file_size(path, error);
+      return error ? 0 : size;
+    }
+
+    size_t budget_;
+    std::string tempDir_;
+    uint64_t inputBytes_;
+    uint64_t readBytes_ = 0;
+    size_t heapBytes_ = 0;
+    uint64_t seq_ = 0;
+    bool failed_ = false;
+
+    MergeIndex index_;
+    std::vector<uint64_t> firstSeen_;
+    TempDirectory directory_;
+    std::vector<RunWriter> partitions_;
+    // Файлы результатов разделов и подразделов для итогового слияния
+    std::vector<std::string> runs_;
+  };
+
+  static uint64_t totalSize(const std::vector<std::string>& files) {
+    uint64_t total = 0;
+    for (const auto& file : files) {
+      std::error_code error;
+      uintmax_t size = std::filesystem::file_size(file, error);
+      if (!error) {
+        total += size;
+      }
+    }
+    return total;
+  }
+};
\ No newline at end of file
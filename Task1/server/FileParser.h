@@ -1,13 +1,49 @@
 #pragma once
 
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <iterator>
+#include <memory>
 #include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+#include "../common/Parallel.h"
+#include "../common/StudentTable.h"
 #include "../common/Validator.h"
+#include "MappedFile.h"
 #include "Student.h"
 
+// Статистика разбора файла
+struct ParseStats {
+  size_t validCount = 0;
+  size_t invalidCount = 0;
+};
+
+// Результат разбора файла, отображённого в память. Имена в records указывают
+// прямо в отображение file, поэтому записи валидны, пока жив этот объект
+struct MappedStudentFile {
+  MappedFile file;
+  std::vector<StudentRecordView> records;
+  ParseStats stats;
+
+  // Копирование записей в самостоятельные объекты Student
+  std::vector<Student> materialize() const {
+    std::vector<Student> students;
+    students.reserve(records.size());
+    for (const auto& record : records) {
+      students.push_back(record.materialize());
+    }
+    return students;
+  }
+};
+
 class FileParser {
  public:
   // Парсинг файла со студентами
@@ -40,7 +76,7 @@ class FileParser {
       Student student;
       if (parseLine(line, student)) {
         if (Validator::validateStudent(student)) {
-          students.push_back(student);
+          students.push_back(std::move(student));
           validCount++;
         } else {
           std::cerr << "   Строка " << lineNumber
@@ -56,17 +92,330 @@ class FileParser {
 
     file.close();
 
+    printSummary(validCount, invalidCount);
+
+    return students;
+  }
+
+  // Парсинг файла через отображение в память. Результат совпадает с
+  // parseFile, но строки не копируются до materialize()
+  static MappedStudentFile mapFile(const std::string& filename) {
+    MappedStudentFile result;
+
+    if (!result.file.open(filename)) {
+      std::cerr << "❌ Ошибка: Не удалось открыть файл: " << filename
+                << std::endl;
+      return result;
+    }
+
+    std::cout << "📂 Чтение файла: " << filename << std::endl;
+
+    parseBuffer(result.file.view(), 1, result.records, result.stats);
+
+    printSummary(result.stats.validCount, result.stats.invalidCount);
+
+    return result;
+  }
+
+  // То же, что parseFile, но через отображение файла в память
+  static std::vector<Student> parseFileMapped(const std::string& filename) {
+    return mapFile(filename).materialize();
+  }
+
+  // Разбор буфера построчно. firstLineNumber — номер первой строки буфера
+  // в исходном файле (для сообщений об ошибках). Записи ссылаются на buffer
+  static void parseBuffer(std::string_view buffer, size_t firstLineNumber,
+                          std::vector<StudentRecordView>& records,
+                          ParseStats& stats) {
+    size_t lineNumber = firstLineNumber;
+    size_t pos = 0;
+
+    // Номера строк записей в конце records, ожидающих проверки имен
+    std::vector<size_t> pendingLines;
+    pendingLines.reserve(VALIDATION_BATCH);
+
+    while (pos < buffer.size()) {
+      const char* lineStart = buffer.data() + pos;
+      const void* newline =
+          std::memchr(lineStart, '\n', buffer.size() - pos);
+      size_t lineLength = newline != nullptr
+                              ? static_cast<const char*>(newline) - lineStart
+                              : buffer.size() - pos;
+      std::string_view line(lineStart, lineLength);
+      pos += lineLength + 1;
+
+      // Пропускаем пустые строки
+      if (line.find_first_not_of(" \t\r\n") == std::string_view::npos) {
+        lineNumber++;
+        continue;
+      }
+
+      StudentRecordView record;
+      std::string_view dateStr;
+      std::string_view extra;
+      bool tokenized = tokenizeLine(line, record, dateStr, extra);
+
+      // Строка разобрана без сообщений: имена проверяются позже пакетом
+      if (tokenized && extra.empty() &&
+          Validator::tryParseDate(dateStr, record.birthDate)) {
+        records.push_back(record);
+        pendingLines.push_back(lineNumber);
+        if (pendingLines.size() == VALIDATION_BATCH) {
+          validatePending(records, pendingLines, stats);
+        }
+        lineNumber++;
+        continue;
+      }
+
+      // Строка выведет сообщения — сначала проверяем накопленный пакет,
+      // чтобы сохранить порядок вывода
+      validatePending(records, pendingLines, stats);
+
+      bool parsed = tokenized;
+      if (parsed) {
+        // Проверяем, что в строке нет лишних данных
+        if (!extra.empty()) {
+          Validator::errors() << "⚠️  Предупреждение: Лишние данные в строке: "
+                              << extra << std::endl;
+        }
+        parsed = Validator::parseDate(dateStr, record.birthDate);
+      }
+
+      if (parsed) {
+        if (Validator::validateStudent(record)) {
+          records.push_back(record);
+          stats.validCount++;
+        } else {
+          Validator::errors() << "   Строка " << lineNumber
+                              << " отклонена из-за ошибок валидации"
+                              << std::endl;
+          stats.invalidCount++;
+        }
+      } else {
+        Validator::errors() << "   Строка " << lineNumber
+                            << ": Ошибка парсинга: " << line << std::endl;
+        stats.invalidCount++;
+      }
+
+      lineNumber++;
+    }
+
+    validatePending(records, pendingLines, stats);
+  }
+
+  // Параллельный вариант mapFile: файл делится на диапазоны по границам
+  // строк, каждый диапазон разбирается в своем потоке, записи склеиваются
+  // в исходном порядке. threadCount == 0 — по числу ядер
+  static MappedStudentFile mapFileParallel(const std::string& filename,
+                                           unsigned threadCount = 0) {
+    MappedStudentFile result;
+
+    if (!result.file.open(filename)) {
+      std::cerr << "❌ Ошибка: Не удалось открыть файл: " << filename
+                << std::endl;
+      return result;
+    }
+
+    std::cout << "📂 Чтение файла: " << filename << std::endl;
+
+    auto chunks = parseChunks(result.file.view(), threadCount, result.stats);
+
+    result.records.reserve(result.stats.validCount);
+    for (auto& chunk : chunks) {
+      result.records.insert(result.records.end(), chunk.begin(), chunk.end());
+    }
+
+    printSummary(result.stats.validCount, result.stats.invalidCount);
+
+    return result;
+  }
+
+  // Параллельный вариант parseFileMapped: разбор и создание объектов
+  // Student выполняются в рабочих потоках
+  static std::vector<Student> parseFileParallel(const std::string& filename,
+                                                unsigned threadCount = 0) {
+    std::vector<Student> students;
+    MappedFile file;
+
+    if (!file.open(filename)) {
+      std::cerr << "❌ Ошибка: Не удалось открыть файл: " << filename
+                << std::endl;
+      return students;
+    }
+
+    std::cout << "📂 Чтение файла: " << filename << std::endl;
+
+    ParseStats stats;
+    auto chunks = parseChunks(file.view(), threadCount, stats);
+
+    std::vector<std::vector<Student>> parts(chunks.size());
+    parallelFor(chunks.size(), threadCount, [&](size_t i) {
+      parts[i].reserve(chunks[i].size());
+      for (const auto& record : chunks[i]) {
+        parts[i].push_back(record.materialize());
+      }
+      std::vector<StudentRecordView>().swap(chunks[i]);
+    });
+
+    students.reserve(stats.validCount);
+    for (auto& part : parts) {
+      std::move(part.begin(), part.end(), std::back_inserter(students));
+    }
+
+    printSummary(stats.validCount, stats.invalidCount);
+
+    return students;
+  }
+
+  // Парсинг файла сразу в таблицу: имена интернируются в pool (или в новый
+  // пул таблицы), объекты Student не создаются. Сообщения и состав записей —
+  // как у parseFile
+  static StudentTable parseFileTable(
+      const std::string& filename,
+      std::shared_ptr<StringPool> pool = nullptr) {
+    StudentTable table(std::move(pool));
+    streamFile(filename, TABLE_WINDOW_SIZE,
+               [&](const std::vector<StudentRecordView>& records,
+                   std::string_view) {
+                 for (const auto& record : records) {
+                   table.add(record);
+                 }
+                 return true;
+               });
+    return table;
+  }
+
+  // Потоковый разбор файла окнами примерно по windowSize байт (по границам
+  // строк). Для каждого окна вызывается onRecords(records, window); записи
+  // действительны только внутри вызова, после него страницы окна
+  // освобождаются, так что память не зависит от размера файла. Если
+  // onRecords возвращает false, разбор прерывается
+  template <typename Fn>
+  static bool streamFile(const std::string& filename, size_t windowSize,
+                         Fn onRecords) {
+    MappedFile file;
+
+    if (!file.open(filename)) {
+      std::cerr << "❌ Ошибка: Не удалось открыть файл: " << filename
+                << std::endl;
+      return false;
+    }
+
+    std::cout << "📂 Чтение файла: " << filename << std::endl;
+
+    std::string_view buffer = file.view();
+    std::vector<StudentRecordView> records;
+    ParseStats stats;
+    size_t lineNumber = 1;
+
+    for (size_t offset = 0; offset < buffer.size();) {
+      size_t end = std::min(offset + std::max<size_t>(windowSize, 1),
+                            buffer.size());
+      if (end < buffer.size()) {
+        size_t newline = buffer.find('\n', end - 1);
+        end = newline != std::string_view::npos ? newline + 1 : buffer.size();
+      }
+
+      std::string_view window = buffer.substr(offset, end - offset);
+      records.clear();
+      parseBuffer(window, lineNumber, records, stats);
+      lineNumber += std::count(window.begin(), window.end(), '\n');
+
+      if (!onRecords(records, window)) {
+        return false;
+      }
+
+      file.release(offset, end);
+      offset = end;
+    }
+
+    printSummary(stats.validCount, stats.invalidCount);
+
+    return true;
+  }
+
+ private:
+  // Минимальный размер диапазона для отдельного потока
+  static constexpr size_t MIN_CHUNK_SIZE = 1 << 20;
+
+  // Размер окна при разборе файла в таблицу
+  static constexpr size_t TABLE_WINDOW_SIZE = 8 << 20;
+
+  // Число записей в пакете проверки имен
+  static constexpr size_t VALIDATION_BATCH = 1024;
+
+  // Деление буфера на chunkCount диапазонов, каждый из которых (кроме,
+  // возможно, последнего) заканчивается символом перевода строки
+  static std::vector<std::string_view> splitIntoChunks(std::string_view buffer,
+                                                       size_t chunkCount) {
+    std::vector<std::string_view> chunks;
+    size_t begin = 0;
+
+    for (size_t i = 1; i <= chunkCount && begin < buffer.size(); ++i) {
+      size_t end = buffer.size();
+      if (i < chunkCount) {
+        size_t target = std::max(begin, buffer.size() / chunkCount * i);
+        size_t newline = buffer.find('\n', target);
+        end = newline == std::string_view::npos ? buffer.size() : newline + 1;
+      }
+      chunks.push_back(buffer.substr(begin, end - begin));
+      begin = end;
+    }
+
+    return chunks;
+  }
+
+  // Параллельный разбор буфера. Сначала в каждом диапазоне считаются
+  // переводы строк, чтобы знать номер его первой строки; затем диапазоны
+  // разбираются, а сообщения об ошибках копятся в буфере диапазона и
+  // выводятся по порядку после завершения всех потоков
+  static std::vector<std::vector<StudentRecordView>> parseChunks(
+      std::string_view buffer, unsigned threadCount, ParseStats& stats) {
+    if (threadCount == 0) {
+      threadCount = defaultThreadCount();
+    }
+    size_t chunkCount = std::max<size_t>(
+        1, std::min<size_t>(threadCount, buffer.size() / MIN_CHUNK_SIZE));
+
+    auto chunks = splitIntoChunks(buffer, chunkCount);
+
+    std::vector<size_t> firstLines(chunks.size() + 1, 0);
+    parallelFor(chunks.size(), threadCount, [&](size_t i) {
+      firstLines[i + 1] =
+          std::count(chunks[i].begin(), chunks[i].end(), '\n');
+    });
+    firstLines[0] = 1;
+    for (size_t i = 1; i < firstLines.size(); ++i) {
+      firstLines[i] += firstLines[i - 1];
+    }
+
+    std::vector<std::vector<StudentRecordView>> records(chunks.size());
+    std::vector<ParseStats> chunkStats(chunks.size());
+    std::vector<std::ostringstream> logs(chunks.size());
+
+    parallelFor(chunks.size(), threadCount, [&](size_t i) {
+      Validator::ErrorRedirect redirect(logs[i]);
+      parseBuffer(chunks[i], firstLines[i], records[i], chunkStats[i]);
+    });
+
+    for (size_t i = 0; i < chunks.size(); ++i) {
+      Validator::errors() << logs[i].str();
+      stats.validCount += chunkStats[i].validCount;
+      stats.invalidCount += chunkStats[i].invalidCount;
+    }
+
+    return records;
+  }
+
+  static void printSummary(size_t validCount, size_t invalidCount) {
     std::cout << "✅ Обработано: " << validCount << " корректных записей"
               << std::endl;
     if (invalidCount > 0) {
       std::cout << "⚠️  Отклонено: " << invalidCount << " некорректных записей"
                 << std::endl;
     }
-
-    return students;
   }
 
- private:
   // Парсинг одной строки: ID FirstName MiddleName LastName DD.MM.YYYY
   static bool parseLine(const std::string& line, Student& student) {
     std::istringstream iss(line);
@@ -94,4 +443,117 @@ class FileParser {
     // Парсим дату
     return Validator::parseDate(dateStr, student.birthDate);
   }
+
+  // Проверка имен последних pendingLines.size() записей одним пакетом.
+  // Отклоненные записи удаляются, по ним выводятся те же сообщения, что и
+  // при построчной проверке
+  static void validatePending(std::vector<StudentRecordView>& records,
+                              std::vector<size_t>& pendingLines,
+                              ParseStats& stats) {
+    size_t count = pendingLines.size();
+    if (count == 0) {
+      return;
+    }
+
+    size_t first = records.size() - count;
+    uint8_t namesOk[VALIDATION_BATCH];
+    Validator::validateNames(records.data() + first, count, namesOk);
+
+    size_t kept = first;
+    for (size_t i = 0; i < count; ++i) {
+      const StudentRecordView& record = records[first + i];
+      if (namesOk[i] && record.id > 0) {
+        records[kept++] = record;
+        stats.validCount++;
+      } else {
+        // Повторная проверка выводит сообщение о первой ошибке
+        Validator::validateStudent(record);
+        Validator::errors() << "   Строка " << pendingLines[i]
+                            << " отклонена из-за ошибок валидации"
+                            << std::endl;
+        stats.invalidCount++;
+      }
+    }
+
+    records.resize(kept);
+    pendingLines.clear();
+  }
+
+  // Разбор строки на поля без выделения памяти и без вывода сообщений.
+  // Повторяет поведение operator>> из parseLine: пробельные символы
+  // пропускаются, ID может быть со знаком и не обязан отделяться пробелом от
+  // имени, переполнение int — ошибка. extra — первый лишний токен, если есть
+  static bool tokenizeLine(std::string_view line, StudentRecordView& record,
+                           std::string_view& dateStr,
+                           std::string_view& extra) {
+    size_t pos = 0;
+
+    if (!readInt(line, pos, record.id) ||
+        !readToken(line, pos, record.firstName) ||
+        !readToken(line, pos, record.middleName) ||
+        !readToken(line, pos, record.lastName) ||
+        !readToken(line, pos, dateStr)) {
+      return false;
+    }
+
+    readToken(line, pos, extra);
+    return true;
+  }
+
+  static bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' ||
+           c == '\r';
+  }
+
+  static void skipSpaces(std::string_view line, size_t& pos) {
+    while (pos < line.size() && isSpace(line[pos])) {
+      pos++;
+    }
+  }
+
+  static bool readToken(std::string_view line, size_t& pos,
+                        std::string_view& token) {
+    skipSpaces(line, pos);
+    size_t start = pos;
+    while (pos < line.size() && !isSpace(line[pos])) {
+      pos++;
+    }
+    token = line.substr(start, pos - start);
+    return !token.empty();
+  }
+
+  static bool readInt(std::string_view line, size_t& pos, int& value) {
+    skipSpaces(line, pos);
+
+    bool negative = false;
+    if (pos < line.size() && (line[pos] == '+' || line[pos] == '-')) {
+      negative = line[pos] == '-';
+      pos++;
+    }
+
+    size_t digitsStart = pos;
+    long long result = 0;
+    bool overflow = false;
+    while (pos < line.size() && line[pos] >= '0' && line[pos] <= '9') {
+      if (!overflow) {
+        result = result * 10 + (line[pos] - '0');
+        overflow = result > static_cast<long long>(INT_MAX) + 1;
+      }
+      pos++;
+    }
+
+    if (pos == digitsStart || overflow) {
+      return false;
+    }
+
+    if (negative) {
+      result = -result;
+    }
+    if (result > INT_MAX || result < INT_MIN) {
+      return false;
+    }
+
+    value = static_cast<int>(result);
+    return true;
+  }
 };
\ No newline at end of file
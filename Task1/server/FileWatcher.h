@@ -0,0 +1,152 @@
+#pragma once
+
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Наблюдение за входными файлами через inotify (Linux, RAII).
+// Наблюдаются каталоги, в которых лежат файлы, а не сами файлы: редакторы
+// часто записывают новый файл и переименовывают его поверх старого, и
+// наблюдение за старым файлом после этого ничего не сообщает. Каталог во
+// входном списке наблюдается целиком: новый или удаленный файл в нем тоже
+// изменение
+class FileWatcher {
+ public:
+  explicit FileWatcher(const std::vector<std::string>& inputs) {
+    fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd_ < 0) {
+      std::cerr << "❌ Ошибка inotify: " << std::strerror(errno) << std::endl;
+      return;
+    }
+
+    namespace fs = std::filesystem;
+    for (const auto& input : inputs) {
+      std::error_code error;
+      fs::path path = fs::absolute(input, error);
+      if (fs::is_directory(path, error)) {
+        addWatch(path.string(), "", input);
+      } else {
+        addWatch(path.parent_path().string(), path.filename().string(),
+                 input);
+      }
+    }
+  }
+
+  ~FileWatcher() {
+    if (fd_ >= 0) {
+      ::close(fd_);
+    }
+  }
+
+  FileWatcher(const FileWatcher&) = delete;
+  FileWatcher& operator=(const FileWatcher&) = delete;
+
+  bool isOpen() const { return fd_ >= 0 && !watches_.empty(); }
+
+  // Ожидание изменений не дольше timeout. После первого события изменения
+  // собираются, пока файлы не затихнут на QUIET_PERIOD: запись большого
+  // файла дает много событий, а разбирать его нужно один раз (но не
+  // дольше MAX_BATCH_TIME, если файл пишется непрерывно). Возвращает
+  // измененные пути в том виде, в котором они заданы во входном списке
+  // (для каталога — путь каталога); пусто, если изменений не было. Без
+  // наблюдения (!isOpen()) просто ждет timeout, чтобы цикл ожидания не
+  // занимал процессор
+  std::vector<std::string> wait(std::chrono::milliseconds timeout) {
+    std::set<std::string> changed;
+    if (!isOpen()) {
+      std::this_thread::sleep_for(timeout);
+      return {};
+    }
+    if (!poll(timeout)) {
+      return {};
+    }
+
+    readEvents(changed);
+    auto deadline = std::chrono::steady_clock::now() + MAX_BATCH_TIME;
+    while (std::chrono::steady_clock::now() < deadline &&
+           poll(QUIET_PERIOD)) {
+      readEvents(changed);
+    }
+    return std::vector<std::string>(changed.begin(), changed.end());
+  }
+
+ private:
+  // Наблюдение за каталогом: name — имя файла в нем или пусто (весь
+  // каталог), input — как этот путь задан во входном списке. Для одного
+  // каталога inotify выдает одно наблюдение
+  void addWatch(const std::string& directory, const std::string& name,
+                const std::string& input) {
+    int wd = inotify_add_watch(fd_, directory.c_str(), WATCH_EVENTS);
+    if (wd < 0) {
+      std::cerr << "⚠️  Не удалось наблюдать за " << directory << ": "
+                << std::strerror(errno) << std::endl;
+      return;
+    }
+
+    Watch& watch = watches_[wd];
+    if (name.empty()) {
+      watch.directoryInput = input;
+    } else {
+      watch.files[name] = input;
+    }
+  }
+
+  bool poll(std::chrono::milliseconds timeout) {
+    pollfd item{fd_, POLLIN, 0};
+    return ::poll(&item, 1, static_cast<int>(timeout.count())) > 0 &&
+           (item.revents & POLLIN);
+  }
+
+  void readEvents(std::set<std::string>& changed) {
+    alignas(inotify_event) char buffer[EVENT_BUFFER_SIZE];
+
+    ssize_t length;
+    while ((length = ::read(fd_, buffer, sizeof(buffer))) > 0) {
+      for (char* pos = buffer; pos < buffer + length;) {
+        const auto* event = reinterpret_cast<const inotify_event*>(pos);
+        pos += sizeof(inotify_event) + event->len;
+
+        auto watch = watches_.find(event->wd);
+        if (watch == watches_.end() || event->len == 0) {
+          continue;
+        }
+
+        const Watch& target = watch->second;
+        auto file = target.files.find(event->name);
+        if (file != target.files.end()) {
+          changed.insert(file->second);
+        } else if (!target.directoryInput.empty()) {
+          changed.insert(target.directoryInput);
+        }
+      }
+    }
+  }
+
+  // Наблюдение за каталогом: отдельные файлы (имя -> входной путь) и,
+  // если каталог задан во входном списке целиком, его входной путь
+  struct Watch {
+    std::map<std::string, std::string> files;
+    std::string directoryInput;
+  };
+
+  static constexpr uint32_t WATCH_EVENTS = IN_CLOSE_WRITE | IN_MODIFY |
+                                           IN_CREATE | IN_DELETE |
+                                           IN_MOVED_FROM | IN_MOVED_TO;
+  static constexpr std::chrono::milliseconds QUIET_PERIOD{200};
+  static constexpr std::chrono::milliseconds MAX_BATCH_TIME{2000};
+  static constexpr size_t EVENT_BUFFER_SIZE = 64 * 1024;
+
+  int fd_ = -1;
+  std::map<int, Watch> watches_;
+};
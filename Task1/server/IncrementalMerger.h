@@ -0,0 +1,244 @@
+#pragma once
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../common/Student.h"
+#include "FileParser.h"
+#include "MappedFile.h"
+#include "MergeIndex.h"
+#include "StudentMerger.h"
+
+// Объединение входных файлов для долго работающего сервера: записи каждого
+// файла хранятся отдельно, и при изменении файлов разбираются только
+// изменившиеся. Если файл дописан (начало совпадает с уже разобранным),
+// разбираются только новые строки; иначе файл перечитывается целиком.
+// Объединенный список строится заново из хранимых записей (без разбора) и
+// сравнивается с предыдущим по ключу объединения: результат — изменения
+// StudentDelta, которые публикуются вместо всего списка
+class IncrementalMerger {
+ public:
+  using Roster = std::shared_ptr<const std::vector<Student>>;
+
+  explicit IncrementalMerger(std::vector<std::string> inputs)
+      : inputs_(std::move(inputs)),
+        roster_(std::make_shared<const std::vector<Student>>()) {}
+
+  // Разбор всех файлов и объединение. Состав, ID и порядок — как у
+  // StudentMerger::mergeFiles
+  Roster load() {
+    files_.clear();
+    order_ = StudentMerger::collectFiles(inputs_);
+
+    std::cout << "\n🔄 Объединение " << order_.size() << " файлов..."
+              << std::endl;
+    for (const auto& path : order_) {
+      reparse(path, files_[path]);
+    }
+
+    return rebuild(nullptr);
+  }
+
+  // Обработка изменений: changed — измененные входы (файлы или каталоги из
+  // входного списка). Кроме них проверяются размер и время изменения всех
+  // файлов: в каталоге неизвестно, какой файл изменился. В delta —
+  // изменения относительно предыдущего списка (пусто, если список не
+  // изменился); возвращается новый список
+  Roster reload(const std::vector<std::string>& changed, StudentDelta& delta) {
+    delta = StudentDelta();
+    std::set<std::string> touched(changed.begin(), changed.end());
+
+    std::vector<std::string> order = StudentMerger::collectFiles(inputs_);
+    std::map<std::string, FileState> files;
+    bool modified = order != order_;
+
+    for (const auto& path : order) {
+      auto previous = files_.find(path);
+      FileState& state = files[path];
+      if (previous == files_.end()) {
+        reparse(path, state);
+        modified = true;
+        continue;
+      }
+
+      state = std::move(previous->second);
+      if (touched.count(path) > 0 || state.stamp != stampOf(path)) {
+        update(path, state);
+        modified = true;
+      }
+    }
+    for (const auto& entry : files_) {
+      if (files.count(entry.first) == 0) {
+        std::cout << "🗑  Файл удален из входных данных: " << entry.first
+                  << std::endl;
+      }
+    }
+
+    files_ = std::move(files);
+    order_ = std::move(order);
+    return modified ? rebuild(&delta) : roster_;
+  }
+
+  const Roster& students() const { return roster_; }
+  const std::vector<std::string>& inputs() const { return inputs_; }
+
+ private:
+  // Размер и время изменения файла: по ним видно, что файл изменился
+  struct Stamp {
+    long long size = -1;
+    long long mtimeNs = 0;
+
+    bool operator!=(const Stamp& other) const {
+      return size != other.size || mtimeNs != other.mtimeNs;
+    }
+  };
+
+  // Разобранный файл. parsedBytes — длина разобранного начала, которое
+  // заканчивается переводом строки (0, если файл не заканчивается им:
+  // последняя строка может быть дописана, и такой файл перечитывается
+  // целиком); prefixHash — его хеш, lines — число строк в нем
+  struct FileState {
+    std::vector<Student> records;
+    Stamp stamp;
+    size_t parsedBytes = 0;
+    uint64_t prefixHash = 0;
+    size_t lines = 0;
+  };
+
+  static Stamp stampOf(const std::string& path) {
+    struct stat st;
+    Stamp stamp;
+    if (::stat(path.c_str(), &st) == 0) {
+      stamp.size = static_cast<long long>(st.st_size);
+      stamp.mtimeNs = static_cast<long long>(st.st_mtim.tv_sec) * 1000000000LL +
+                      st.st_mtim.tv_nsec;
+    }
+    return stamp;
+  }
+
+  // Полный разбор файла (параллельный, как у StudentMerger::mergeFiles)
+  static void reparse(const std::string& path, FileState& state) {
+    state = FileState();
+    state.stamp = stampOf(path);
+
+    MappedStudentFile parsed = FileParser::mapFileParallel(path);
+    state.records = parsed.materialize();
+    remember(parsed.file.view(), state);
+  }
+
+  // Разбор измененного файла: если уже разобранное начало не изменилось,
+  // разбираются только дописанные строки
+  static void update(const std::string& path, FileState& state) {
+    MappedFile file;
+    if (state.parsedBytes == 0 || !file.open(path) ||
+        file.size() < state.parsedBytes ||
+        MergeIndex::hashContent(file.view().substr(0, state.parsedBytes)) !=
+            state.prefixHash) {
+      std::cout << "📝 Файл изменен, разбор целиком: " << path << std::endl;
+      reparse(path, state);
+      return;
+    }
+
+    state.stamp = stampOf(path);
+    std::string_view appended = file.view().substr(state.parsedBytes);
+    std::vector<StudentRecordView> records;
+    ParseStats stats;
+    FileParser::parseBuffer(appended, state.lines + 1, records, stats);
+    for (const auto& record : records) {
+      state.records.push_back(record.materialize());
+    }
+    std::cout << "📝 Файл дописан: " << path << ", новых записей: "
+              << stats.validCount;
+    if (stats.invalidCount > 0) {
+      std::cout << ", отклонено: " << stats.invalidCount;
+    }
+    std::cout << std::endl;
+
+    remember(file.view(), state);
+  }
+
+  static void remember(std::string_view content, FileState& state) {
+    if (content.empty() || content.back() != '\n') {
+      state.parsedBytes = 0;
+      state.prefixHash = 0;
+      state.lines = 0;
+      return;
+    }
+    state.parsedBytes = content.size();
+    state.prefixHash = MergeIndex::hashContent(content);
+    state.lines = static_cast<size_t>(
+        std::count(content.begin(), content.end(), '\n'));
+  }
+
+  // Объединение хранимых записей и сравнение с предыдущим списком (если
+  // delta задан)
+  Roster rebuild(StudentDelta* delta) {
+    size_t total = 0;
+    for (const auto& path : order_) {
+      total += files_[path].records.size();
+    }
+
+    MergeIndex index(total);
+    for (const auto& path : order_) {
+      for (const auto& record : files_[path].records) {
+        index.add(record);
+      }
+    }
+
+    if (delta != nullptr) {
+      diff(index, *delta);
+    }
+
+    size_t duplicatesFound = index.duplicates();
+    roster_ =
+        std::make_shared<const std::vector<Student>>(index.takeStudents());
+
+    std::cout << "✅ Объединение завершено:" << std::endl;
+    std::cout << "   Уникальных студентов: " << roster_->size() << std::endl;
+    if (duplicatesFound > 0) {
+      std::cout << "   Найдено дубликатов: " << duplicatesFound << std::endl;
+    }
+    return roster_;
+  }
+
+  // Изменения нового списка (index) относительно roster_: студенты
+  // прежнего списка ищутся в индексе по ключу, не найденные удалены,
+  // найденные с другими ID изменены, оставшиеся в индексе добавлены
+  void diff(const MergeIndex& index, StudentDelta& delta) const {
+    const std::vector<Student>& merged = index.students();
+    std::vector<bool> seen(merged.size(), false);
+
+    for (const auto& student : *roster_) {
+      size_t position = index.find(student);
+      if (position == MergeIndex::NOT_FOUND) {
+        delta.removed.push_back(student);
+        continue;
+      }
+      seen[position] = true;
+      if (merged[position].ids != student.ids) {
+        delta.updated.push_back(merged[position]);
+      }
+    }
+
+    for (size_t i = 0; i < merged.size(); ++i) {
+      if (!seen[i]) {
+        delta.added.push_back(merged[i]);
+      }
+    }
+  }
+
+  std::vector<std::string> inputs_;
+  std::vector<std::string> order_;
+  std::map<std::string, FileState> files_;
+  Roster roster_;
+};
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <string>
+#include <string_view>
+#include <utility>
+
+// Файл, отображённый в память только для чтения (POSIX mmap, RAII).
+// Пустой файл открывается успешно и даёт пустое представление
+class MappedFile {
+ public:
+  MappedFile() = default;
+
+  explicit MappedFile(const std::string& filename) { open(filename); }
+
+  ~MappedFile() { close(); }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  MappedFile(MappedFile&& other) noexcept
+      : data_(std::exchange(other.data_, nullptr)),
+        size_(std::exchange(other.size_, 0)),
+        open_(std::exchange(other.open_, false)) {}
+
+  MappedFile& operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+      close();
+      data_ = std::exchange(other.data_, nullptr);
+      size_ = std::exchange(other.size_, 0);
+      open_ = std::exchange(other.open_, false);
+    }
+    return *this;
+  }
+
+  // Отображение файла в память
+  bool open(const std::string& filename) {
+    close();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+      ::close(fd);
+      return false;
+    }
+
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ > 0) {
+      void* mapped = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (mapped == MAP_FAILED) {
+        ::close(fd);
+        size_ = 0;
+        return false;
+      }
+      // Файл читается один раз от начала до конца
+      madvise(mapped, size_, MADV_SEQUENTIAL);
+      data_ = mapped;
+    }
+
+    // Отображение остаётся валидным и после закрытия дескриптора
+    ::close(fd);
+    open_ = true;
+    return true;
+  }
+
+  void close() {
+    if (data_ != nullptr) {
+      munmap(data_, size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    open_ = false;
+  }
+
+  bool isOpen() const { return open_; }
+  const char* data() const { return static_cast<const char*>(data_); }
+  size_t size() const { return size_; }
+  std::string_view view() const { return std::string_view(data(), size_); }
+
+  // Освобождение уже прочитанных страниц диапазона [begin, end). Данные
+  // остаются доступными: при обращении страницы снова читаются из файла
+  void release(size_t begin, size_t end) {
+    static const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    begin -= begin % pageSize;
+    end -= end % pageSize;
+    if (data_ != nullptr && begin < end && end <= size_) {
+      madvise(static_cast<char*>(data_) + begin, end - begin, MADV_DONTNEED);
+    }
+  }
+
+ private:
+  void* data_ = nullptr;
+  size_t size_ = 0;
+  bool open_ = false;
+};
\ No newline at end of file
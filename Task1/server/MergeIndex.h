@@ -0,0 +1,276 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "../common/Student.h"
+
+// Индекс для объединения студентов по ФИО и дате рождения.
+// Ключ — 64-битный хеш имен вместе с упакованной датой; таблица с открытой
+// адресацией и линейным пробированием хранит хеш, дату и номер студента.
+// Имена сравниваются целиком только при совпадении хеша и даты.
+// Студенты хранятся в порядке первого появления ключа: объединенный список
+// детерминирован и повторяет порядок входных данных без дубликатов
+class MergeIndex {
+ public:
+  // До этого числа ID дубликаты ищутся линейно, дальше — через
+  // хеш-множество (и при объединении таблиц, StudentMerger::mergeTables)
+  static constexpr size_t SMALL_ID_SET = 16;
+
+  explicit MergeIndex(size_t expectedStudents = 0) {
+    reserve(expectedStudents);
+  }
+
+  // Подготовка таблицы под count уникальных студентов
+  void reserve(size_t count) {
+    size_t capacity = MIN_CAPACITY;
+    while (capacity * MAX_LOAD_PERCENT < count * 100) {
+      capacity *= 2;
+    }
+    if (capacity > slots_.size()) {
+      rehash(capacity);
+    }
+  }
+
+  // Добавление студента. Если такой студент уже есть, его ID добавляются
+  // к найденной записи (без повторов) и возвращается true
+  bool add(const Student& student) { return insert(student); }
+  bool add(Student&& student) { return insert(std::move(student)); }
+
+  // Добавление записи из буфера файла: Student создается только для нового
+  // студента, для дубликата добавляется лишь ID
+  bool add(const StudentRecordView& record) { return insert(record); }
+
+  // Добавление с заранее вычисленным hashKey(student)
+  bool add(const Student& student, uint64_t hash) {
+    return insertHashed(student, hash);
+  }
+
+  size_t size() const { return students_.size(); }
+  size_t duplicates() const { return duplicates_; }
+
+  const std::vector<Student>& students() const { return students_; }
+
+  // Номер студента с тем же ключом объединения, что у student, или
+  // NOT_FOUND
+  static constexpr size_t NOT_FOUND = SIZE_MAX;
+
+  size_t find(const Student& student) const {
+    uint64_t hash = hashKey(student);
+    uint32_t date = student.birthDate.pack();
+    size_t mask = slots_.size() - 1;
+
+    for (size_t i = hash & mask; slots_[i].index != EMPTY;
+         i = (i + 1) & mask) {
+      const Slot& slot = slots_[i];
+      if (slot.hash == hash && slot.date == date &&
+          sameKey(students_[slot.index], student)) {
+        return slot.index;
+      }
+    }
+    return NOT_FOUND;
+  }
+
+  // Память под список студентов и таблицу (без строк и ID внутри Student)
+  size_t tableBytes() const {
+    return students_.capacity() * sizeof(Student) +
+           slots_.capacity() * sizeof(Slot);
+  }
+
+  // Пиковая память под список и таблицу при добавлении нового студента:
+  // при росте старый и новый буферы существуют одновременно
+  size_t tableBytesOnInsert() const {
+    size_t bytes = tableBytes();
+    if (students_.size() == students_.capacity()) {
+      bytes += std::max<size_t>(students_.capacity() * 2, 1) * sizeof(Student);
+    }
+    if ((students_.size() + 1) * 100 > slots_.size() * MAX_LOAD_PERCENT) {
+      bytes += slots_.size() * 2 * sizeof(Slot);
+    }
+    return bytes;
+  }
+
+  // Забирает объединенный список; индекс после этого пуст
+  std::vector<Student> takeStudents() {
+    std::vector<Student> result = std::move(students_);
+    clear();
+    return result;
+  }
+
+  void clear() {
+    students_.clear();
+    slots_.assign(MIN_CAPACITY, Slot{});
+    largeIdSets_.clear();
+    duplicates_ = 0;
+  }
+
+  // Хеш ключа объединения: имена (с длинами, чтобы "ab c" != "a bc") и дата
+  static uint64_t hashKey(std::string_view firstName,
+                          std::string_view middleName,
+                          std::string_view lastName, uint32_t packedDate) {
+    uint64_t hash = HASH_SEED ^ packedDate;
+    hash = hashBytes(hash, firstName);
+    hash = hashBytes(hash, middleName);
+    hash = hashBytes(hash, lastName);
+    return finalize(hash);
+  }
+
+  static uint64_t hashKey(const Student& student) {
+    return hashKey(student.firstName, student.middleName, student.lastName,
+                   student.birthDate.pack());
+  }
+
+  // Хеш произвольных байтов тем же перемешиванием, что и у ключа
+  static uint64_t hashContent(std::string_view bytes) {
+    return finalize(hashBytes(HASH_SEED, bytes));
+  }
+
+  template <typename StudentT>
+  static bool sameKey(const Student& a, const StudentT& b) {
+    return a.birthDate == b.birthDate && a.lastName == b.lastName &&
+           a.firstName == b.firstName && a.middleName == b.middleName;
+  }
+
+ private:
+  struct Slot {
+    uint64_t hash = 0;
+    uint32_t date = 0;
+    uint32_t index = EMPTY;
+  };
+
+  static constexpr uint32_t EMPTY = UINT32_MAX;
+  static constexpr size_t MIN_CAPACITY = 16;
+  static constexpr size_t MAX_LOAD_PERCENT = 70;
+  static constexpr uint64_t HASH_SEED = 0x2545F4914F6CDD1DULL;
+  static constexpr uint64_t HASH_MULTIPLIER = 0x9E3779B97F4A7C15ULL;
+
+  template <typename StudentT>
+  bool insert(StudentT&& student) {
+    uint64_t hash = hashKey(student.firstName, student.middleName,
+                            student.lastName, student.birthDate.pack());
+    return insertHashed(std::forward<StudentT>(student), hash);
+  }
+
+  template <typename StudentT>
+  bool insertHashed(StudentT&& student, uint64_t hash) {
+    if ((students_.size() + 1) * 100 > slots_.size() * MAX_LOAD_PERCENT) {
+      rehash(slots_.size() * 2);
+    }
+
+    uint32_t date = student.birthDate.pack();
+    size_t mask = slots_.size() - 1;
+
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+      Slot& slot = slots_[i];
+
+      if (slot.index == EMPTY) {
+        slot.hash = hash;
+        slot.date = date;
+        slot.index = static_cast<uint32_t>(students_.size());
+        students_.push_back(toStudent(std::forward<StudentT>(student)));
+        return false;
+      }
+
+      if (slot.hash == hash && slot.date == date &&
+          sameKey(students_[slot.index], student)) {
+        mergeIds(slot.index, student);
+        duplicates_++;
+        return true;
+      }
+    }
+  }
+
+  static Student toStudent(Student&& student) { return std::move(student); }
+  static Student toStudent(const Student& student) { return student; }
+  static Student toStudent(const StudentRecordView& record) {
+    return record.materialize();
+  }
+
+  void mergeIds(uint32_t index, const Student& student) {
+    for (int id : student.ids) {
+      mergeId(index, id);
+    }
+  }
+
+  void mergeIds(uint32_t index, const StudentRecordView& record) {
+    mergeId(index, record.id);
+  }
+
+  void mergeId(uint32_t index, int id) {
+    std::vector<int>& target = students_[index].ids;
+
+    if (target.size() < SMALL_ID_SET) {
+      if (std::find(target.begin(), target.end(), id) == target.end()) {
+        target.push_back(id);
+      }
+      return;
+    }
+
+    auto& idSet = largeIdSets_[index];
+    if (idSet.empty()) {
+      idSet.insert(target.begin(), target.end());
+    }
+    if (idSet.insert(id).second) {
+      target.push_back(id);
+    }
+  }
+
+  void rehash(size_t capacity) {
+    std::vector<Slot> slots(capacity);
+    size_t mask = capacity - 1;
+
+    for (const Slot& slot : slots_) {
+      if (slot.index == EMPTY) continue;
+      size_t i = slot.hash & mask;
+      while (slots[i].index != EMPTY) {
+        i = (i + 1) & mask;
+      }
+      slots[i] = slot;
+    }
+
+    slots_ = std::move(slots);
+  }
+
+  static uint64_t hashBytes(uint64_t hash, std::string_view bytes) {
+    const char* data = bytes.data();
+    size_t size = bytes.size();
+
+    while (size >= 8) {
+      uint64_t word;
+      std::memcpy(&word, data, 8);
+      hash = (hash ^ word) * HASH_MULTIPLIER;
+      hash ^= hash >> 29;
+      data += 8;
+      size -= 8;
+    }
+
+    uint64_t tail = 0;
+    if (size > 0) {
+      std::memcpy(&tail, data, size);
+    }
+    hash = (hash ^ tail ^ (static_cast<uint64_t>(bytes.size()) << 56)) *
+           HASH_MULTIPLIER;
+    return hash ^ (hash >> 29);
+  }
+
+  // Финальное перемешивание (fmix64 из MurmurHash3)
+  static uint64_t finalize(uint64_t hash) {
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ULL;
+    hash ^= hash >> 33;
+    return hash;
+  }
+
+  std::vector<Student> students_;
+  std::vector<Slot> slots_ = std::vector<Slot>(MIN_CAPACITY);
+  std::unordered_map<uint32_t, std::unordered_set<int>> largeIdSets_;
+  size_t duplicates_ = 0;
+};
\ No newline at end of file
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "../common/Student.h"
+
+// Индексы объединенного списка для поиска отдельных студентов. Список не
+// копируется: индекс хранит его (shared_ptr) и номера строк в нем.
+// - по ID: хеш-таблица ID -> строки (каждый ID объединенной записи). ID
+//   может повторяться в разных записях (один ID у разных ФИО или дат во
+//   входных файлах): поиск находит все такие записи;
+// - по ФИО: строки, упорядоченные как строки getFullName(); записи с
+//   общим началом ФИО идут подряд, поиск по началу — двоичный;
+// - по дате рождения: строки, упорядоченные по дате (при равной дате — по
+//   ФИО), диапазон дат — двоичный поиск границ.
+// Индекс не меняется после построения; для нового списка строится новый
+class StudentIndex {
+ public:
+  using Roster = std::shared_ptr<const std::vector<Student>>;
+
+  explicit StudentIndex(Roster students) : students_(std::move(students)) {
+    const std::vector<Student>& list = *students_;
+
+    // Записи, повторяющие ID более ранней записи, учитываются в
+    // idCollisions_; один ID, повторенный в записи, хранится один раз
+    byId_.reserve(list.size());
+    for (size_t row = 0; row < list.size(); ++row) {
+      for (int id : list[row].ids) {
+        auto range = byId_.equal_range(id);
+        if (std::any_of(range.first, range.second, [&](const auto& entry) {
+              return entry.second == row;
+            })) {
+          continue;
+        }
+        if (range.first != range.second) {
+          idCollisions_++;
+        }
+        byId_.emplace(id, static_cast<uint32_t>(row));
+      }
+    }
+    if (idCollisions_ > 0) {
+      std::cerr << "⚠️  ID повторяются в разных записях: " << idCollisions_
+                << std::endl;
+    }
+
+    byName_.resize(list.size());
+    std::iota(byName_.begin(), byName_.end(), 0);
+    std::sort(byName_.begin(), byName_.end(), [&](uint32_t a, uint32_t b) {
+      int result = list[a].fullNameRef().compare(list[b].fullNameRef());
+      return result != 0 ? result < 0 : a < b;
+    });
+
+    byDate_ = byName_;
+    std::stable_sort(byDate_.begin(), byDate_.end(),
+                     [&](uint32_t a, uint32_t b) {
+                       return list[a].birthDate.pack() <
+                              list[b].birthDate.pack();
+                     });
+  }
+
+  size_t size() const { return students_->size(); }
+  const Roster& students() const { return students_; }
+
+  // Сколько раз запись повторила ID более ранней записи
+  size_t idCollisions() const { return idCollisions_; }
+
+  // Результаты поиска — номера строк списка students().
+  // Студенты с этим ID по порядку списка (обычно один, несколько — если
+  // ID повторяется в разных записях): не больше limit; total — сколько
+  // найдено всего
+  std::vector<uint32_t> findById(int id, size_t limit, size_t& total) const {
+    auto range = byId_.equal_range(id);
+    std::vector<uint32_t> rows;
+    for (auto entry = range.first; entry != range.second; ++entry) {
+      rows.push_back(entry->second);
+    }
+    std::sort(rows.begin(), rows.end());
+    return collect(rows.begin(), rows.end(), limit, total);
+  }
+
+  // Студенты, строка ФИО которых начинается с prefix, по порядку ФИО: не
+  // больше limit; total — сколько найдено всего
+  std::vector<uint32_t> findByNamePrefix(std::string_view prefix,
+                                         size_t limit, size_t& total) const {
+    const std::vector<Student>& list = *students_;
+    auto first = std::lower_bound(
+        byName_.begin(), byName_.end(), prefix,
+        [&](uint32_t row, std::string_view bound) {
+          return list[row].fullNameRef().compare(bound) < 0;
+        });
+    auto last = std::partition_point(first, byName_.end(), [&](uint32_t row) {
+      return list[row].fullNameRef().startsWith(prefix);
+    });
+    return collect(first, last, limit, total);
+  }
+
+  // Студенты, родившиеся с from по to включительно, по дате и ФИО: не
+  // больше limit; total — сколько найдено всего
+  std::vector<uint32_t> findByBirthDate(const Date& from, const Date& to,
+                                        size_t limit, size_t& total) const {
+    const std::vector<Student>& list = *students_;
+    auto first = std::lower_bound(
+        byDate_.begin(), byDate_.end(), from.pack(),
+        [&](uint32_t row, uint32_t bound) {
+          return list[row].birthDate.pack() < bound;
+        });
+    auto last = std::upper_bound(
+        first, byDate_.end(), to.pack(), [&](uint32_t bound, uint32_t row) {
+          return bound < list[row].birthDate.pack();
+        });
+    return collect(first, last, limit, total);
+  }
+
+ private:
+  using RowIterator = std::vector<uint32_t>::const_iterator;
+
+  static std::vector<uint32_t> collect(RowIterator first, RowIterator last,
+                                       size_t limit, size_t& total) {
+    total = static_cast<size_t>(last - first);
+    return std::vector<uint32_t>(first, first + std::min(total, limit));
+  }
+
+  Roster students_;
+  std::unordered_multimap<int, uint32_t> byId_;
+  size_t idCollisions_ = 0;
+  std::vector<uint32_t> byName_;
+  std::vector<uint32_t> byDate_;
+};
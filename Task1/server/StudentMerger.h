@@ -1,44 +1,149 @@
 #pragma once
 
 #include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <future>
 #include <iostream>
-#include <map>
+#include <iterator>
+#include <queue>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
+#include "../common/Parallel.h"
 #include "../common/Student.h"
+#include "../common/StudentTable.h"
+#include "FileParser.h"
+#include "MergeIndex.h"
+
+// Порядок результата параллельного объединения
+enum class MergeOrder {
+  ByShard,    // шарды подряд, внутри шарда — порядок первого появления
+  FirstSeen,  // k-way слияние шардов: тот же порядок, что у mergeStudents
+};
+
+// Статистика одного шарда параллельного объединения
+struct ShardStats {
+  size_t records = 0;
+  size_t unique = 0;
+  long long mergeMs = 0;
+};
 
 class StudentMerger {
  public:
-  // Объединяет списки студентов, объединяя дубликаты по ФИО и дате рождения
+  // Объединяет списки студентов, объединяя дубликаты по ФИО и дате рождения.
+  // Порядок результата — порядок первого появления студента: сначала
+  // студенты list1, затем новые студенты list2
   static std::vector<Student> mergeStudents(const std::vector<Student>& list1,
-                                            const std::vector<Student>& list2) {
+                                            const std::vector<Student>& list2,
+                                            bool logDuplicates = true) {
     std::cout << "\n🔄 Объединение списков студентов..." << std::endl;
     std::cout << "   Список 1: " << list1.size() << " записей" << std::endl;
     std::cout << "   Список 2: " << list2.size() << " записей" << std::endl;
 
-    // Используем map для группировки по уникальному ключу
-    std::map<std::string, Student> studentMap;
+    // Индекс по хешу ФИО и дате рождения
+    MergeIndex index(list1.size() + list2.size());
 
     // Добавляем студентов из первого списка
     for (const auto& student : list1) {
-      addStudentToMap(studentMap, student);
+      addStudent(index, student, logDuplicates);
     }
 
     // Добавляем студентов из второго списка
     for (const auto& student : list2) {
-      addStudentToMap(studentMap, student);
+      addStudent(index, student, logDuplicates);
+    }
+
+    size_t duplicatesFound = index.duplicates();
+    std::vector<Student> mergedList = index.takeStudents();
+
+    std::cout << "✅ Объединение завершено:" << std::endl;
+    std::cout << "   Уникальных студентов: " << mergedList.size() << std::endl;
+    if (duplicatesFound > 0) {
+      std::cout << "   Найдено дубликатов: " << duplicatesFound << std::endl;
+    }
+
+    return mergedList;
+  }
+
+  // То же для таблиц. Имена в таблицах уже интернированы, поэтому ключ
+  // объединения — номера имен в пуле и упакованная дата, строки не
+  // сравниваются. Результат использует пул list1 (имена list2 из другого
+  // пула переводятся в него); состав, ID и порядок — как у mergeStudents
+  // для списков Student
+  static StudentTable mergeStudents(const StudentTable& list1,
+                                    const StudentTable& list2,
+                                    bool logDuplicates = true) {
+    std::cout << "\n🔄 Объединение списков студентов..." << std::endl;
+    std::cout << "   Список 1: " << list1.size() << " записей" << std::endl;
+    std::cout << "   Список 2: " << list2.size() << " записей" << std::endl;
+
+    size_t duplicatesFound = 0;
+    StudentTable mergedList =
+        mergeTables({&list1, &list2}, logDuplicates, duplicatesFound);
+
+    std::cout << "✅ Объединение завершено:" << std::endl;
+    std::cout << "   Уникальных студентов: " << mergedList.size() << std::endl;
+    if (duplicatesFound > 0) {
+      std::cout << "   Найдено дубликатов: " << duplicatesFound << std::endl;
+    }
+
+    return mergedList;
+  }
+
+  // Объединяет произвольное число входных файлов. Каталог во входном
+  // списке заменяется его обычными файлами (без рекурсии, по имени).
+  // Каждый файл разбирается в отображение в память и сразу прогоняется
+  // через общий индекс, промежуточные списки не склеиваются. Разбор
+  // следующего файла идет в фоне, пока объединяется текущий.
+  // Порядок результата — порядок первого появления студента
+  static std::vector<Student> mergeFiles(
+      const std::vector<std::string>& inputs) {
+    std::vector<std::string> files = collectFiles(inputs);
+
+    std::cout << "\n🔄 Объединение " << files.size() << " файлов..."
+              << std::endl;
+
+    MergeIndex index;
+    std::vector<ShardSummary> summaries;
+    summaries.reserve(files.size());
+
+    std::future<MappedStudentFile> next;
+    if (!files.empty()) {
+      next = std::async(std::launch::async, parseShard, files[0]);
     }
 
-    // Преобразуем map обратно в vector
-    std::vector<Student> mergedList;
-    mergedList.reserve(studentMap.size());
+    for (size_t k = 0; k < files.size(); ++k) {
+      MappedStudentFile shard = next.get();
+      if (k + 1 < files.size()) {
+        next = std::async(std::launch::async, parseShard, files[k + 1]);
+      }
+
+      auto start = std::chrono::steady_clock::now();
+      size_t uniqueBefore = index.size();
+      for (const auto& record : shard.records) {
+        index.add(record);
+      }
+      auto elapsed = std::chrono::steady_clock::now() - start;
 
-    for (auto& pair : studentMap) {
-      mergedList.push_back(std::move(pair.second));
+      summaries.push_back(
+          {files[k], shard.records.size(), index.size() - uniqueBefore,
+           std::chrono::duration_cast<std::chrono::milliseconds>(elapsed)
+               .count()});
     }
 
-    int duplicatesFound = (list1.size() + list2.size()) - mergedList.size();
+    size_t duplicatesFound = index.duplicates();
+    std::vector<Student> mergedList = index.takeStudents();
 
     std::cout << "✅ Объединение завершено:" << std::endl;
+    for (const auto& summary : summaries) {
+      std::cout << "   " << summary.file << ": " << summary.records
+                << " записей, новых студентов: " << summary.added << " ("
+                << summary.mergeMs << " мс)" << std::endl;
+    }
     std::cout << "   Уникальных студентов: " << mergedList.size() << std::endl;
     if (duplicatesFound > 0) {
       std::cout << "   Найдено дубликатов: " << duplicatesFound << std::endl;
@@ -47,26 +152,355 @@ class StudentMerger {
     return mergedList;
   }
 
+  // Раскрытие каталогов во входном списке
+  static std::vector<std::string> collectFiles(
+      const std::vector<std::string>& inputs) {
+    namespace fs = std::filesystem;
+    std::vector<std::string> files;
+
+    for (const auto& input : inputs) {
+      std::error_code error;
+      if (!fs::is_directory(input, error)) {
+        files.push_back(input);
+        continue;
+      }
+
+      std::vector<std::string> directoryFiles;
+      for (const auto& entry : fs::directory_iterator(input, error)) {
+        if (entry.is_regular_file(error)) {
+          directoryFiles.push_back(entry.path().string());
+        }
+      }
+      if (error) {
+        std::cerr << "⚠️  Ошибка чтения каталога " << input << ": "
+                  << error.message() << std::endl;
+      }
+
+      std::sort(directoryFiles.begin(), directoryFiles.end());
+      files.insert(files.end(), directoryFiles.begin(), directoryFiles.end());
+    }
+
+    return files;
+  }
+
+  // Параллельное объединение нескольких списков. Записи распределяются по
+  // shardCount шардам по старшим битам хеша ключа (MergeIndex::hashKey),
+  // каждый шард объединяется своим потоком в собственном индексе, без общих
+  // блокировок. Внутри шарда сохраняется порядок входных записей, поэтому ID
+  // объединяются так же, как при последовательном объединении.
+  // shardCount == 0 — по числу ядер. stats (если задан) получает время и
+  // размер каждого шарда, чтобы видеть перекос на реальных данных
+  static std::vector<Student> mergeStudentsParallel(
+      const std::vector<std::vector<Student>>& lists, unsigned shardCount = 0,
+      MergeOrder order = MergeOrder::ByShard,
+      std::vector<ShardStats>* stats = nullptr) {
+    if (shardCount == 0) {
+      shardCount = defaultThreadCount();
+    }
+
+    std::cout << "\n🔄 Параллельное объединение " << lists.size()
+              << " списков на " << shardCount << " шардах..." << std::endl;
+
+    // Сквозная нумерация записей всех списков
+    std::vector<size_t> offsets(lists.size() + 1, 0);
+    for (size_t i = 0; i < lists.size(); ++i) {
+      offsets[i + 1] = offsets[i] + lists[i].size();
+    }
+    size_t total = offsets.back();
+
+    // Шаг 1: каждый поток раскладывает свой диапазон записей по шардам
+    size_t sliceCount = shardCount;
+    std::vector<std::vector<std::vector<ShardEntry>>> buckets(
+        sliceCount, std::vector<std::vector<ShardEntry>>(shardCount));
+
+    parallelFor(sliceCount, shardCount, [&](size_t slice) {
+      size_t begin = total * slice / sliceCount;
+      size_t end = total * (slice + 1) / sliceCount;
+      size_t list = std::upper_bound(offsets.begin(), offsets.end(), begin) -
+                    offsets.begin() - 1;
+
+      for (size_t seq = begin; seq < end; ++seq) {
+        while (seq >= offsets[list + 1]) {
+          list++;
+        }
+        const Student& student = lists[list][seq - offsets[list]];
+        uint64_t hash = MergeIndex::hashKey(student);
+        size_t shard = ((hash >> 32) * shardCount) >> 32;
+        buckets[slice][shard].push_back({&student, hash, seq});
+      }
+    });
+
+    // Шаг 2: каждый шард объединяется независимо
+    std::vector<std::vector<Student>> shardStudents(shardCount);
+    std::vector<std::vector<size_t>> firstSeen(shardCount);
+    std::vector<ShardStats> shardStats(shardCount);
+
+    parallelFor(shardCount, shardCount, [&](size_t shard) {
+      auto start = std::chrono::steady_clock::now();
+
+      size_t records = 0;
+      for (size_t slice = 0; slice < sliceCount; ++slice) {
+        records += buckets[slice][shard].size();
+      }
+
+      MergeIndex index(records);
+      for (size_t slice = 0; slice < sliceCount; ++slice) {
+        for (const ShardEntry& entry : buckets[slice][shard]) {
+          if (!index.add(*entry.student, entry.hash)) {
+            firstSeen[shard].push_back(entry.seq);
+          }
+        }
+        std::vector<ShardEntry>().swap(buckets[slice][shard]);
+      }
+      shardStudents[shard] = index.takeStudents();
+
+      auto elapsed = std::chrono::steady_clock::now() - start;
+      shardStats[shard].records = records;
+      shardStats[shard].unique = shardStudents[shard].size();
+      shardStats[shard].mergeMs =
+          std::chrono::duration_cast<std::chrono::milliseconds>(elapsed)
+              .count();
+    });
+
+    // Шаг 3: сборка результата
+    std::vector<Student> mergedList = order == MergeOrder::FirstSeen
+                                          ? mergeByFirstSeen(shardStudents,
+                                                             firstSeen)
+                                          : concatShards(shardStudents);
+
+    std::cout << "✅ Объединение завершено:" << std::endl;
+    for (size_t shard = 0; shard < shardCount; ++shard) {
+      std::cout << "   Шард " << shard << ": " << shardStats[shard].records
+                << " записей, уникальных: " << shardStats[shard].unique
+                << " (" << shardStats[shard].mergeMs << " мс)" << std::endl;
+    }
+    std::cout << "   Уникальных студентов: " << mergedList.size() << std::endl;
+    if (total > mergedList.size()) {
+      std::cout << "   Найдено дубликатов: " << total - mergedList.size()
+                << std::endl;
+    }
+
+    if (stats != nullptr) {
+      *stats = std::move(shardStats);
+    }
+
+    return mergedList;
+  }
+
  private:
-  static void addStudentToMap(std::map<std::string, Student>& studentMap,
-                              const Student& student) {
-    std::string key = student.getUniqueKey();
-
-    auto it = studentMap.find(key);
-    if (it != studentMap.end()) {
-      // Студент уже существует - добавляем ID
-      for (int id : student.ids) {
-        // Проверяем, что ID еще не добавлен
-        if (std::find(it->second.ids.begin(), it->second.ids.end(), id) ==
-            it->second.ids.end()) {
-          it->second.ids.push_back(id);
+  struct ShardEntry {
+    const Student* student;
+    uint64_t hash;
+    size_t seq;
+  };
+
+  static std::vector<Student> concatShards(
+      std::vector<std::vector<Student>>& shardStudents) {
+    size_t total = 0;
+    for (const auto& shard : shardStudents) {
+      total += shard.size();
+    }
+
+    std::vector<Student> result;
+    result.reserve(total);
+    for (auto& shard : shardStudents) {
+      std::move(shard.begin(), shard.end(), std::back_inserter(result));
+    }
+    return result;
+  }
+
+  // k-way слияние шардов по номеру первого появления студента. Внутри шарда
+  // номера уже возрастают, поэтому достаточно кучи из shardCount элементов
+  static std::vector<Student> mergeByFirstSeen(
+      std::vector<std::vector<Student>>& shardStudents,
+      const std::vector<std::vector<size_t>>& firstSeen) {
+    using HeapItem = std::pair<size_t, size_t>;  // номер записи, шард
+    std::priority_queue<HeapItem, std::vector<HeapItem>, std::greater<>> heap;
+    std::vector<size_t> positions(shardStudents.size(), 0);
+
+    size_t total = 0;
+    for (size_t shard = 0; shard < shardStudents.size(); ++shard) {
+      total += shardStudents[shard].size();
+      if (!firstSeen[shard].empty()) {
+        heap.push({firstSeen[shard][0], shard});
+      }
+    }
+
+    std::vector<Student> result;
+    result.reserve(total);
+    while (!heap.empty()) {
+      size_t shard = heap.top().second;
+      heap.pop();
+
+      size_t& position = positions[shard];
+      result.push_back(std::move(shardStudents[shard][position]));
+      if (++position < firstSeen[shard].size()) {
+        heap.push({firstSeen[shard][position], shard});
+      }
+    }
+    return result;
+  }
+
+  // Ключ объединения строки таблицы
+  struct TableKey {
+    uint32_t firstName;
+    uint32_t middleName;
+    uint32_t lastName;
+    uint32_t date;
+
+    bool operator==(const TableKey& other) const {
+      return firstName == other.firstName && middleName == other.middleName &&
+             lastName == other.lastName && date == other.date;
+    }
+
+    uint64_t hash() const {
+      uint64_t hash = ((static_cast<uint64_t>(firstName) << 32) | middleName) *
+                      0x9E3779B97F4A7C15ULL;
+      hash ^= ((static_cast<uint64_t>(lastName) << 32) | date) *
+              0xC2B2AE3D27D4EB4FULL;
+      hash ^= hash >> 32;
+      hash *= 0xD6E8FEB86659FD93ULL;
+      return hash ^ (hash >> 32);
+    }
+  };
+
+  // Объединение строк нескольких таблиц. Первый проход назначает каждой
+  // строке группу (уникального студента) по таблице с открытой адресацией
+  // и собирает пары (группа, ID) в порядке входа; второй раскладывает ID по
+  // группам подсчетом и убирает повторы, сохраняя первое появление
+  static StudentTable mergeTables(
+      const std::vector<const StudentTable*>& tables, bool logDuplicates,
+      size_t& duplicatesFound) {
+    StudentTable merged(tables.empty() ? nullptr : tables[0]->sharedPool());
+    StringPool& pool = *merged.sharedPool();
+
+    size_t rowCount = 0;
+    size_t idCount = 0;
+    for (const StudentTable* table : tables) {
+      rowCount += table->size();
+      for (size_t row = 0; row < table->size(); ++row) {
+        idCount += table->ids(row).size();
+      }
+    }
+
+    // Таблица групп рассчитана на все строки сразу и не растет
+    size_t capacity = 16;
+    while (capacity * 7 < rowCount * 10) {
+      capacity *= 2;
+    }
+    std::vector<uint32_t> slots(capacity, 0);  // номер группы + 1
+    size_t mask = capacity - 1;
+
+    std::vector<TableKey> keys;
+    std::vector<uint32_t> idGroups;
+    std::vector<int> ids;
+    idGroups.reserve(idCount);
+    ids.reserve(idCount);
+    duplicatesFound = 0;
+
+    for (const StudentTable* table : tables) {
+      bool samePool = table->sharedPool() == merged.sharedPool();
+      std::vector<uint32_t> translated;
+      if (!samePool) {
+        translated.assign(table->pool().size(), UINT32_MAX);
+      }
+      auto nameId = [&](uint32_t id) {
+        if (samePool) return id;
+        if (translated[id] == UINT32_MAX) {
+          translated[id] = pool.intern(table->pool().get(id));
+        }
+        return translated[id];
+      };
+
+      for (size_t row = 0; row < table->size(); ++row) {
+        TableKey key{nameId(table->firstNameId(row)),
+                     nameId(table->middleNameId(row)),
+                     nameId(table->lastNameId(row)), table->packedDate(row)};
+
+        size_t i = key.hash() & mask;
+        while (slots[i] != 0 && !(keys[slots[i] - 1] == key)) {
+          i = (i + 1) & mask;
+        }
+        if (slots[i] == 0) {
+          keys.push_back(key);
+          slots[i] = static_cast<uint32_t>(keys.size());
+        } else {
+          duplicatesFound++;
+          if (logDuplicates) {
+            std::cout << "   🔗 Дубликат найден: " << table->fullName(row)
+                      << " (ID объединены)" << std::endl;
+          }
+        }
+
+        for (int id : table->ids(row)) {
+          idGroups.push_back(slots[i] - 1);
+          ids.push_back(id);
         }
       }
+    }
+    std::vector<uint32_t>().swap(slots);
+
+    // Раскладка ID по группам с сохранением порядка
+    std::vector<uint32_t> starts(keys.size() + 1, 0);
+    for (uint32_t group : idGroups) {
+      starts[group + 1]++;
+    }
+    for (size_t group = 0; group < keys.size(); ++group) {
+      starts[group + 1] += starts[group];
+    }
+    std::vector<int> grouped(ids.size());
+    std::vector<uint32_t> positions(starts.begin(), starts.end() - 1);
+    for (size_t i = 0; i < ids.size(); ++i) {
+      grouped[positions[idGroups[i]]++] = ids[i];
+    }
+
+    merged.reserve(keys.size(), grouped.size());
+    std::vector<int> unique;
+    std::unordered_set<int> seen;
+    for (size_t group = 0; group < keys.size(); ++group) {
+      const int* first = grouped.data() + starts[group];
+      const int* last = grouped.data() + starts[group + 1];
+
+      unique.clear();
+      if (last - first <= static_cast<ptrdiff_t>(MergeIndex::SMALL_ID_SET)) {
+        for (const int* id = first; id != last; ++id) {
+          if (std::find(unique.begin(), unique.end(), *id) == unique.end()) {
+            unique.push_back(*id);
+          }
+        }
+      } else {
+        seen.clear();
+        for (const int* id = first; id != last; ++id) {
+          if (seen.insert(*id).second) {
+            unique.push_back(*id);
+          }
+        }
+      }
+
+      const TableKey& key = keys[group];
+      merged.addRow(key.firstName, key.middleName, key.lastName, key.date,
+                    unique.data(), unique.size());
+    }
+
+    return merged;
+  }
+
+  struct ShardSummary {
+    std::string file;
+    size_t records;
+    size_t added;
+    long long mergeMs;
+  };
+
+  static MappedStudentFile parseShard(const std::string& filename) {
+    return FileParser::mapFileParallel(filename);
+  }
+
+  static void addStudent(MergeIndex& index, const Student& student,
+                         bool logDuplicates) {
+    if (index.add(student) && logDuplicates) {
       std::cout << "   🔗 Дубликат найден: " << student.getFullName()
                 << " (ID объединены)" << std::endl;
-    } else {
-      // Новый студент
-      studentMap[key] = student;
     }
   }
 };
\ No newline at end of file
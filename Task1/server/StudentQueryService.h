@@ -0,0 +1,178 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <zmq.hpp>
+
+#include "../common/Protocol.h"
+#include "../common/Student.h"
+#include "Serializer.h"
+#include "StudentIndex.h"
+
+// Сервис запросов к объединенному списку (ROUTER): поиск студента по ID,
+// по началу ФИО и по диапазону дат рождения без рассылки всего списка
+// (protocol::QUERY). Запросы обслуживаются в отдельном потоке по индексу
+// StudentIndex. Новый список (update) индексируется в вызывающем потоке и
+// подменяет прежний целиком: запрос видит либо старый, либо новый список
+class StudentQueryService {
+ public:
+  using Roster = StudentIndex::Roster;
+
+  explicit StudentQueryService(const std::string& endpoint)
+      : endpoint_(endpoint) {}
+
+  ~StudentQueryService() { stop(); }
+
+  StudentQueryService(const StudentQueryService&) = delete;
+  StudentQueryService& operator=(const StudentQueryService&) = delete;
+
+  // Общий контекст ZeroMQ (для адресов inproc://); задается до start()
+  void setContext(std::shared_ptr<zmq::context_t> context) {
+    context_ = std::move(context);
+  }
+
+  void start(Roster students) {
+    update(std::move(students));
+    if (serving_.exchange(true)) {
+      return;
+    }
+    queries_ = 0;
+    serviceThread_ = std::thread(&StudentQueryService::serviceLoop, this);
+
+    std::cout << "🔎 Сервис запросов запущен" << std::endl;
+    std::cout << "   QUERY: " << endpoint_ << std::endl;
+  }
+
+  // Замена списка (например, после изменения входных файлов)
+  void update(Roster students) {
+    auto index = std::make_shared<const StudentIndex>(std::move(students));
+    std::lock_guard<std::mutex> lock(indexMutex_);
+    index_ = std::move(index);
+  }
+
+  void stop() {
+    if (!serving_.exchange(false)) {
+      return;
+    }
+    if (serviceThread_.joinable()) {
+      serviceThread_.join();
+    }
+    std::cout << "🔎 Сервис запросов остановлен (запросов: " << queries_
+              << ")" << std::endl;
+  }
+
+  size_t queryCount() const { return queries_; }
+
+ private:
+  std::shared_ptr<const StudentIndex> index() {
+    std::lock_guard<std::mutex> lock(indexMutex_);
+    return index_;
+  }
+
+  void serviceLoop() {
+    try {
+      std::shared_ptr<zmq::context_t> ownedContext =
+          context_ != nullptr ? context_
+                              : std::make_shared<zmq::context_t>(1);
+      zmq::socket_t service(*ownedContext, zmq::socket_type::router);
+      service.set(zmq::sockopt::linger, 0);
+      service.bind(endpoint_);
+
+      while (serving_) {
+        zmq::pollitem_t items[] = {{service.handle(), 0, ZMQ_POLLIN, 0}};
+        zmq::poll(items, 1, POLL_INTERVAL);
+        if (!(items[0].revents & ZMQ_POLLIN)) {
+          continue;
+        }
+
+        // Конверт ROUTER: идентификатор, пустой разделитель (от REQ) и
+        // тело запроса последней частью
+        std::vector<zmq::message_t> envelope;
+        zmq::message_t part;
+        while (service.recv(part, zmq::recv_flags::dontwait)) {
+          bool more = part.more();
+          envelope.push_back(std::move(part));
+          if (!more) {
+            answer(service, envelope);
+            envelope.clear();
+          }
+        }
+      }
+    } catch (const zmq::error_t& e) {
+      std::cerr << "❌ ZMQ Query Service ошибка: " << e.what() << std::endl;
+    }
+  }
+
+  // Ответ на запрос: "OK <найдено>" и записи в двоичном формате либо
+  // "ERROR <причина>" и пустая часть
+  void answer(zmq::socket_t& service, std::vector<zmq::message_t>& envelope) {
+    if (envelope.size() < 2) {
+      return;
+    }
+    const zmq::message_t& request = envelope.back();
+    std::string_view requestText(static_cast<const char*>(request.data()),
+                                 request.size());
+
+    std::string status;
+    std::string payload;
+    protocol::Query query;
+    std::shared_ptr<const StudentIndex> current = index();
+    if (current == nullptr) {
+      status = std::string(protocol::QUERY_ERROR) + " список не загружен";
+    } else if (!protocol::parseQuery(requestText, query)) {
+      status = std::string(protocol::QUERY_ERROR) + " неверный запрос";
+    } else {
+      size_t total = 0;
+      std::vector<uint32_t> rows = find(*current, query, total);
+      status = std::string(protocol::OK) + " " + std::to_string(total);
+      payload = Serializer::serializeBinaryRows(*current->students(),
+                                                rows.data(), rows.size());
+    }
+
+    for (size_t i = 0; i + 1 < envelope.size(); ++i) {
+      service.send(envelope[i], zmq::send_flags::sndmore);
+    }
+    zmq::message_t reply(status.data(), status.size());
+    service.send(reply, zmq::send_flags::sndmore);
+    zmq::message_t data(payload.data(), payload.size());
+    service.send(data, zmq::send_flags::none);
+    queries_++;
+  }
+
+  static std::vector<uint32_t> find(const StudentIndex& index,
+                                    const protocol::Query& query,
+                                    size_t& total) {
+    switch (query.kind) {
+      case protocol::QueryKind::Id:
+        return index.findById(query.id, protocol::QUERY_LIMIT, total);
+      case protocol::QueryKind::Name:
+        return index.findByNamePrefix(query.namePrefix, protocol::QUERY_LIMIT,
+                                      total);
+      case protocol::QueryKind::Dates:
+        return index.findByBirthDate(query.from, query.to,
+                                     protocol::QUERY_LIMIT, total);
+    }
+    total = 0;
+    return {};
+  }
+
+  static constexpr std::chrono::milliseconds POLL_INTERVAL{100};
+
+  std::string endpoint_;
+  std::shared_ptr<zmq::context_t> context_;
+  std::thread serviceThread_;
+  std::atomic<bool> serving_{false};
+  std::atomic<size_t> queries_{0};
+
+  std::mutex indexMutex_;
+  std::shared_ptr<const StudentIndex> index_;
+};
@@ -1,16 +1,49 @@
 #pragma once
 
+#include <unistd.h>
+
+#include <algorithm>
 #include <atomic>
+#include <cerrno>
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <string_view>
 #include <thread>
+#include <utility>
+#include <vector>
 #include <zmq.hpp>
 
+#include "../common/Protocol.h"
+#include "../common/SharedMemory.h"
 #include "../common/Student.h"
 #include "Serializer.h"
 
 class ZmqSyncedPublisher {
  public:
+  // Число записей в пакете потоковой публикации по умолчанию
+  static constexpr size_t DEFAULT_BATCH_SIZE = 4096;
+
+  // Статистика надежной доставки потока
+  struct DeliveryStats {
+    size_t nacks = 0;                 // запросов NACK
+    size_t retransmittedBatches = 0;  // пакетов, отправленных повторно
+    size_t retransmittedBytes = 0;    // их размер (записи, без заголовков)
+    size_t streamResends = 0;         // повторов всего потока по таймауту
+    int completedSubscribers = 0;     // подписчиков, подтвердивших прием
+    size_t snapshots = 0;             // снимков, выданных по запросу
+    size_t deltas = 0;                // опубликованных изменений
+    size_t deltaBytes = 0;            // их размер (записи, без заголовков)
+  };
+
   ZmqSyncedPublisher(const std::string& pubEndpoint,
                      const std::string& syncEndpoint)
       : pubEndpoint_(pubEndpoint),
@@ -19,127 +52,1058 @@ class ZmqSyncedPublisher {
 
   ~ZmqSyncedPublisher() { stop(); }
 
-  // Запуск публикации в отдельном потоке
-  void start(const std::vector<Student>& students,
+  // Размер пакета потоковой публикации (записей). Подписчики, запросившие
+  // поток, получают список пакетами и могут разбирать его по мере приема.
+  // 0 — поток отключен, такие подписчики получают двоичный формат целиком.
+  // Действует для следующего start()
+  void setBatchSize(size_t batchSize) { batchSize_ = batchSize; }
+
+  // Канал восстановления (ROUTER) для надежной доставки потока: поток
+  // отправляется один раз, подписчики запрашивают пропущенные пакеты и
+  // подтверждают прием. Без канала поток, как и остальные форматы,
+  // отправляется несколько раз. Действует для следующего start()
+  void setRepairEndpoint(const std::string& repairEndpoint) {
+    repairEndpoint_ = repairEndpoint;
+  }
+
+  // Разбиение потоковой публикации на шарды: пакет содержит записи одного
+  // шарда и публикуется в топике шарда, подписчик получает только свои
+  // шарды (ZeroMQ отбрасывает остальные до отправки). Подписчикам, не
+  // знающим шардов, поток заменяется двоичным форматом целиком. Сервис
+  // снимков выдает только запрошенные шарды. Действует для следующего
+  // start()
+  void setSharding(const protocol::ShardScheme& scheme) { sharding_ = scheme; }
+
+  // Режим общей памяти для подписчиков на этой же машине: двоичный формат
+  // записывается в сегмент общей памяти POSIX один раз, подписчикам
+  // публикуется только описание сегмента (SharedDescriptor), и они
+  // отображают его сами. Без режима такие подписчики получают двоичный
+  // формат. Действует для следующего start()
+  void setSharedMemory(bool sharedMemory) { sharedMemory_ = sharedMemory; }
+
+  // Общий контекст ZeroMQ. Нужен для адресов inproc://, когда publisher и
+  // подписчики работают в одном процессе (контекст у них должен быть
+  // один); по умолчанию у каждого потока publisher свой контекст.
+  // Действует для следующего start()
+  void setContext(std::shared_ptr<zmq::context_t> context) {
+    context_ = std::move(context);
+  }
+
+  // Сколько ждать подключения всех подписчиков; 0 — без ограничения
+  // (пока publisher не остановлен). Действует для следующего start()
+  void setSyncTimeout(std::chrono::milliseconds syncTimeout) {
+    syncTimeout_ = syncTimeout;
+  }
+
+  // Сервис снимков (ROUTER): подписчик, подключившийся в любой момент,
+  // запрашивает весь текущий список и получает его из кеша
+  // сериализованных данных. Сервис работает от start() до stop(), в том
+  // числе после завершения публикации. Действует для следующего start()
+  void setSnapshotEndpoint(const std::string& snapshotEndpoint) {
+    snapshotEndpoint_ = snapshotEndpoint;
+  }
+
+  // Режим изменений: после публикации списка publisher не завершается, а
+  // публикует изменения (publishDelta) в топике DELTA_TOPIC, пока не
+  // остановлен. Подписчики, подключившиеся позже, получают список снимком.
+  // Действует для следующего start()
+  void setLiveUpdates(bool liveUpdates) { liveUpdates_ = liveUpdates; }
+
+  // Публикация изменений списка в режиме изменений. students — список
+  // после изменений: он сразу заменяет текущий (снимки выдают его, даже
+  // пока publisher ждет подписчиков). Изменения отправляются по порядку
+  // после публикации всего списка или истечения ожидания подписчиков
+  void publishDelta(std::shared_ptr<const std::vector<Student>> students,
+                    StudentDelta delta) {
+    if (!running_ || !liveUpdates_) {
+      std::cerr << "⚠️  Publisher не публикует изменения" << std::endl;
+      return;
+    }
+
+    // Номер изменений и новый список — под dataMutex_, как у снимков;
+    // updatesMutex_ сохраняет в очереди порядок номеров
+    {
+      std::lock_guard<std::mutex> updatesLock(updatesMutex_);
+      PendingUpdate update;
+      {
+        std::lock_guard<std::mutex> lock(dataMutex_);
+        update.header.baseId = streamId_;
+        update.header.id = ++streamId_;
+        update.header.recordCount = static_cast<uint32_t>(students->size());
+        studentsData_ = std::move(students);
+        textCache_.reset();
+        binaryCache_.reset();
+        layoutCache_.reset();
+      }
+      update.delta = std::move(delta);
+      pendingUpdates_.push_back(std::move(update));
+    }
+    updatesReady_.notify_one();
+  }
+
+  DeliveryStats deliveryStats() const {
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    return stats_;
+  }
+
+  // Запуск публикации в отдельном потоке. Publisher забирает список
+  // студентов себе (перемещение) или разделяет владение им (shared_ptr),
+  // копия списка не создается. expectedSubscribers — сколько подписчиков
+  // ждать перед отправкой; 0 — не ждать никого (список выдается только
+  // сервисом снимков)
+  void start(std::vector<Student>&& students, int expectedSubscribers = 1) {
+    start(std::make_shared<const std::vector<Student>>(std::move(students)),
+          expectedSubscribers);
+  }
+
+  void start(std::shared_ptr<const std::vector<Student>> students,
              int expectedSubscribers = 1) {
     if (running_) {
       std::cerr << "⚠️  Publisher уже запущен" << std::endl;
       return;
     }
 
+    // Поток предыдущей публикации мог завершиться сам
+    if (publishThread_.joinable()) {
+      publishThread_.join();
+    }
+
     running_ = true;
-    studentsData_ = students;
+    {
+      std::lock_guard<std::mutex> lock(dataMutex_);
+      studentsData_ = std::move(students);
+      streamId_++;
+      textCache_.reset();
+      binaryCache_.reset();
+      layoutCache_.reset();
+    }
+    {
+      std::lock_guard<std::mutex> lock(statsMutex_);
+      stats_ = DeliveryStats();
+    }
+    {
+      std::lock_guard<std::mutex> lock(updatesMutex_);
+      pendingUpdates_.clear();
+    }
     expectedSubscribers_ = expectedSubscribers;
     publishThread_ = std::thread(&ZmqSyncedPublisher::publishLoop, this);
 
+    if (!snapshotEndpoint_.empty() && !serving_) {
+      serving_ = true;
+      snapshotThread_ = std::thread(&ZmqSyncedPublisher::snapshotLoop, this);
+    }
+
     std::cout << "📡 Synced Publisher запущен" << std::endl;
     std::cout << "   PUB: " << pubEndpoint_ << std::endl;
     std::cout << "   SYNC: " << syncEndpoint_ << std::endl;
+    if (!repairEndpoint_.empty()) {
+      std::cout << "   REPAIR: " << repairEndpoint_ << std::endl;
+    }
+    if (!snapshotEndpoint_.empty()) {
+      std::cout << "   SNAPSHOT: " << snapshotEndpoint_ << std::endl;
+    }
+    if (liveUpdates_) {
+      std::cout << "   Изменения: топик " << protocol::DELTA_TOPIC
+                << std::endl;
+    }
+    if (sharding_.enabled()) {
+      std::cout << "   Шарды: " << sharding_.encode() << std::endl;
+    }
   }
 
-  // Остановка публикации
+  // Остановка публикации. Поток присоединяется и тогда, когда публикация
+  // уже завершилась сама
   void stop() {
-    if (!running_) return;
-
-    running_ = false;
+    bool wasRunning = running_.exchange(false);
+    bool wasServing = serving_.exchange(false);
+    updatesReady_.notify_all();
     if (publishThread_.joinable()) {
       publishThread_.join();
     }
+    if (snapshotThread_.joinable()) {
+      snapshotThread_.join();
+    }
+    // Подписчики, уже отобразившие сегмент, сохраняют к нему доступ
+    segment_.remove();
 
-    std::cout << "📡 Synced Publisher остановлен" << std::endl;
+    if (wasRunning || wasServing) {
+      std::cout << "📡 Synced Publisher остановлен" << std::endl;
+    }
   }
 
   bool isRunning() const { return running_; }
 
  private:
+  // Сериализованные данные, общие для всех отправленных сообщений
+  using Payload = std::shared_ptr<const std::string>;
+
+  // Контекст ZeroMQ потока: общий (setContext) или собственный
+  std::shared_ptr<zmq::context_t> makeContext() const {
+    return context_ != nullptr ? context_
+                               : std::make_shared<zmq::context_t>(1);
+  }
+
   void publishLoop() {
     try {
-      zmq::context_t context(1);
+      std::shared_ptr<zmq::context_t> ownedContext = makeContext();
+      zmq::context_t& context = *ownedContext;
 
-      // PUB сокет для отправки данных
-      zmq::socket_t publisher(context, zmq::socket_type::pub);
-      publisher.bind(pubEndpoint_);
+      // Подписчики не ожидаются: список выдает только сервис снимков
+      if (expectedSubscribers_ == 0) {
+        std::cout << "📸 Подписчики не ожидаются, список выдается по "
+                     "запросу снимка"
+                  << std::endl;
+        if (!liveUpdates_) {
+          running_ = false;
+          return;
+        }
+      }
 
-      // REP сокет для синхронизации с подписчиками
-      zmq::socket_t syncService(context, zmq::socket_type::rep);
-      syncService.bind(syncEndpoint_);
+      // Очередь входящих TCP-подключений — не меньше числа подписчиков,
+      // иначе при одновременном подключении часть из них ждет повтора
+      int backlog = std::max(expectedSubscribers_, MIN_BACKLOG);
 
-      std::cout << "⏳ Ожидание подключения " << expectedSubscribers_
-                << " подписчиков..." << std::endl;
+      // XPUB сокет для отправки данных. В отличие от PUB он сообщает о
+      // подписках подписчиков (с xpub_verbose — о каждой, а не только о
+      // первой на топик)
+      zmq::socket_t publisher(context, zmq::socket_type::xpub);
+      publisher.set(zmq::sockopt::xpub_verbose, true);
+      publisher.set(zmq::sockopt::backlog, backlog);
+      publisher.bind(pubEndpoint_);
 
-      // Ждем сигналы готовности от всех подписчиков
-      int subscribersReady = 0;
-      while (subscribersReady < expectedSubscribers_ && running_) {
-        zmq::message_t message;
-        auto result = syncService.recv(message, zmq::recv_flags::dontwait);
+      bool published = expectedSubscribers_ == 0 ||
+                       publishToSubscribers(context, publisher, backlog);
 
-        if (result) {
-          subscribersReady++;
-          std::cout << "   Подписчик #" << subscribersReady << " готов"
+      // Режим изменений: сокет данных остается открытым до stop().
+      // Изменения отправляются и тогда, когда подписчики не подключились:
+      // они получат список снимком
+      if (liveUpdates_) {
+        if (!published) {
+          std::cerr << "⚠️  Список не опубликован, изменения публикуются "
+                       "для подписчиков снимков"
                     << std::endl;
+        }
+        sendUpdates(publisher);
+      }
 
-          // Отправляем подтверждение
-          zmq::message_t reply(2);
-          memcpy(reply.data(), "OK", 2);
-          syncService.send(reply, zmq::send_flags::none);
+    } catch (const zmq::error_t& e) {
+      std::cerr << "❌ ZMQ Synced Publisher ошибка: " << e.what() << std::endl;
+    }
+
+    running_ = false;
+  }
+
+  // Синхронизация с expectedSubscribers_ подписчиками и отправка им
+  // списка. false — подписчики не подключились, и список не отправлен
+  bool publishToSubscribers(zmq::context_t& context, zmq::socket_t& publisher,
+                            int backlog) {
+    // ROUTER сокет для синхронизации с подписчиками: сигналы готовности
+    // принимаются по мере прихода, без поочередного обмена REQ/REP
+    zmq::socket_t syncService(context, zmq::socket_type::router);
+    syncService.set(zmq::sockopt::linger, 0);
+    syncService.set(zmq::sockopt::backlog, backlog);
+    syncService.bind(syncEndpoint_);
+
+    // ROUTER сокет канала восстановления
+    zmq::socket_t repairService(context, zmq::socket_type::router);
+    repairService.set(zmq::sockopt::linger, 0);
+    repairService.set(zmq::sockopt::backlog, backlog);
+    bool reliable = !repairEndpoint_.empty();
+    if (reliable) {
+      repairService.bind(repairEndpoint_);
+    }
+
+    // Публикуемый список и его номер фиксируются до ответов подписчикам
+    // (состав шардов в ответе должен совпасть с потоком): изменения,
+    // принятые во время публикации, подписчики получат следом
+    {
+      std::lock_guard<std::mutex> lock(dataMutex_);
+      streamStudents_ = studentsData_;
+      streamPublication_ = streamId_;
+    }
+    streamLayout_.reset();
+
+    std::cout << "⏳ Ожидание подключения " << expectedSubscribers_
+              << " подписчиков..." << std::endl;
+
+    // Не дождавшись всех, при работающем сервисе снимков отправляем
+    // данные подключившимся: остальные получат снимок
+    SubscriberCounts subscribers;
+    if (!awaitSubscribers(publisher, syncService, subscribers)) {
+      std::cerr << "⚠️  Не все подписчики подключились" << std::endl;
+      if (snapshotEndpoint_.empty() || subscribers.ready == 0 || !running_) {
+        return false;
+      }
+    }
+    int subscribersReady = subscribers.ready;
+    int binarySubscribers = subscribers.binary;
+    int streamSubscribers = subscribers.stream;
+    int sharedSubscribers = subscribers.shared;
+    if (streamSubscribers > 0 && sharding_.enabled()) {
+      streamShardLayout();
+    }
+
+    if (subscribersReady == expectedSubscribers_) {
+      std::cout << "✅ Все подписчики готовы, начинаем отправку" << std::endl;
+    } else {
+      std::cout << "✅ Готово подписчиков: " << subscribersReady << " из "
+                << expectedSubscribers_
+                << ", начинаем отправку (остальные получат снимок)"
+                << std::endl;
+    }
+
+    // Сериализуем данные (один раз) в форматы, которые ждут подписчики
+    int textSubscribers = subscribersReady - binarySubscribers -
+                          streamSubscribers - sharedSubscribers;
+    Payload textData;
+    Payload binaryData;
+    Payload sharedData;
+    if (textSubscribers > 0) {
+      textData = serialized(protocol::WireFormat::Text);
+    }
+    if (binarySubscribers > 0) {
+      binaryData = serialized(protocol::WireFormat::Binary);
+    }
+    if (sharedSubscribers > 0) {
+      sharedData = sharedPayload();
+    }
+
+    std::cout << "📤 Отправка данных (" << streamStudents_->size()
+              << " студентов)..." << std::endl;
+    if (textData != nullptr) {
+      std::cout << "   Текст: " << textData->size() << " байт" << std::endl;
+    }
+    if (binaryData != nullptr) {
+      std::cout << "   Двоичный: " << binaryData->size() << " байт"
+                << std::endl;
+    }
+    if (segment_.isOpen()) {
+      std::cout << "   Общая память: " << segment_.name() << " ("
+                << segment_.size() << " байт, описание "
+                << sharedData->size() << " байт)" << std::endl;
+    }
+    if (streamSubscribers > 0) {
+      std::cout << "   Поток: " << batchCount() << " пакетов по "
+                << batchSize_ << " записей" << std::endl;
+    }
+    if (streamLayout_ != nullptr) {
+      std::cout << "   Шардов: " << streamLayout_->names.size()
+                << std::endl;
+    }
+
+    // Текст, двоичный формат и описание общей памяти отправляются
+    // несколько раз. Поток при наличии канала восстановления уходит один
+    // раз
+    bool reliableStream = reliable && streamSubscribers > 0;
+    int messagesSent = 0;
+    const int MAX_MESSAGES = reliableStream && textData == nullptr &&
+                                     binaryData == nullptr &&
+                                     sharedData == nullptr
+                                 ? 1
+                                 : MAX_SENDS;
+
+    while (running_ && messagesSent < MAX_MESSAGES) {
+      // Отправляем топик и данные
+      if (textData != nullptr) {
+        sendData(publisher, protocol::TEXT_TOPIC, textData);
+      }
+      if (binaryData != nullptr) {
+        sendData(publisher, protocol::BINARY_TOPIC, binaryData);
+      }
+      if (sharedData != nullptr) {
+        sendData(publisher, protocol::SHARED_TOPIC, sharedData);
+      }
+      if (streamSubscribers > 0 && (!reliableStream || messagesSent == 0)) {
+        sendStream(publisher);
+      }
+
+      messagesSent++;
+      std::cout << "   Сообщение " << messagesSent << "/" << MAX_MESSAGES
+                << " отправлено" << std::endl;
+
+      // Паузы нужны только повторам: единственную отправку потока
+      // подтверждает канал восстановления
+      if (MAX_MESSAGES > 1) {
+        std::this_thread::sleep_for(RESEND_INTERVAL);
+      }
+    }
+
+    bool confirmed = reliableStream &&
+                     awaitCompletion(publisher, repairService,
+                                     streamSubscribers);
+
+    std::cout << "✅ Отправка завершена" << std::endl;
+
+    // Даем время доставить последнее сообщение, если прием не подтвержден
+    // всеми подписчиками
+    if (!confirmed) {
+      std::this_thread::sleep_for(DELIVERY_WAIT);
+    }
+    return true;
+  }
+
+  // Изменения, ожидающие отправки, с уже назначенным номером
+  struct PendingUpdate {
+    protocol::DeltaHeader header;
+    StudentDelta delta;
+  };
+
+  // Отправка изменений по мере поступления, пока publisher не остановлен.
+  // Между изменениями из XPUB вычитываются сообщения о подписках, чтобы
+  // они не копились в очереди сокета
+  void sendUpdates(zmq::socket_t& publisher) {
+    std::cout << "🔄 Ожидание изменений списка..." << std::endl;
+
+    while (running_) {
+      PendingUpdate update;
+      {
+        std::unique_lock<std::mutex> lock(updatesMutex_);
+        updatesReady_.wait_for(lock, POLL_INTERVAL, [this] {
+          return !pendingUpdates_.empty() || !running_;
+        });
+        if (pendingUpdates_.empty()) {
+          lock.unlock();
+          zmq::message_t event;
+          while (publisher.recv(event, zmq::recv_flags::dontwait)) {
+          }
+          continue;
         }
+        update = std::move(pendingUpdates_.front());
+        pendingUpdates_.pop_front();
+      }
+      sendDelta(publisher, update);
+    }
+  }
+
+  // Отправка изменений: топик, DeltaHeader и три блока записей. Список
+  // после изменений уже текущий (publishDelta), поэтому снимок всегда
+  // соответствует номеру в нем
+  void sendDelta(zmq::socket_t& publisher, const PendingUpdate& update) {
+    const protocol::DeltaHeader& header = update.header;
+    const StudentDelta& delta = update.delta;
+    Payload parts[] = {
+        std::make_shared<const std::string>(
+            Serializer::serializeBinary(delta.added)),
+        std::make_shared<const std::string>(
+            Serializer::serializeBinary(delta.updated)),
+        std::make_shared<const std::string>(
+            Serializer::serializeBinary(delta.removed))};
+
+    sendTopic(publisher, protocol::DELTA_TOPIC);
+    std::string encoded = header.encode();
+    zmq::message_t headerMessage(encoded.data(), encoded.size());
+    publisher.send(headerMessage, zmq::send_flags::sndmore);
+    size_t bytes = 0;
+    for (size_t i = 0; i < 3; ++i) {
+      sendPayload(publisher, parts[i],
+                  i + 1 < 3 ? zmq::send_flags::sndmore
+                            : zmq::send_flags::none);
+      bytes += parts[i]->size();
+    }
+
+    std::cout << "📤 Изменения #" << header.id << ": добавлено "
+              << delta.added.size() << ", изменено " << delta.updated.size()
+              << ", удалено " << delta.removed.size() << " (" << bytes
+              << " байт, студентов: " << header.recordCount << ")"
+              << std::endl;
+
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    stats_.deltas++;
+    stats_.deltaBytes += bytes;
+  }
+
+  struct SubscriberCounts {
+    int ready = 0;
+    int binary = 0;
+    int stream = 0;
+    int shared = 0;
+  };
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  // Ожидание сигналов готовности от всех подписчиков. Подписчик сообщает,
+  // умеет ли он принимать двоичный формат и пакеты, и получает в ответе
+  // формат, в котором придут данные. Кроме того, ждем, пока подписка SUB
+  // каждого подписчика дойдет до XPUB: все подписчики (и старые)
+  // подписываются на текстовый топик, поэтому готовы столько подписок на
+  // него, сколько сигналов READY. Сокеты опрашиваются через zmq::poll, все
+  // накопившиеся сообщения разбираются сразу. false — истек syncTimeout_
+  // или publisher остановлен раньше, чем подключились все подписчики
+  bool awaitSubscribers(zmq::socket_t& publisher, zmq::socket_t& syncService,
+                        SubscriberCounts& counts) {
+    auto deadline = syncTimeout_.count() > 0
+                        ? std::chrono::steady_clock::now() + syncTimeout_
+                        : std::chrono::steady_clock::time_point::max();
+    int textSubscriptions = 0;
+
+    while (running_ && (counts.ready < expectedSubscribers_ ||
+                        textSubscriptions < counts.ready)) {
+      auto now = std::chrono::steady_clock::now();
+      if (now >= deadline) {
+        break;
       }
+      auto wait = std::min<std::chrono::steady_clock::duration>(
+          POLL_INTERVAL, deadline - now);
+
+      zmq::pollitem_t items[] = {{syncService.handle(), 0, ZMQ_POLLIN, 0},
+                                 {publisher.handle(), 0, ZMQ_POLLIN, 0}};
+      zmq::poll(items, 2,
+                std::chrono::duration_cast<std::chrono::milliseconds>(wait));
 
-      if (subscribersReady < expectedSubscribers_) {
-        std::cerr << "⚠️  Не все подписчики подключились" << std::endl;
-        running_ = false;
-        return;
+      if (items[0].revents & ZMQ_POLLIN) {
+        while (counts.ready < expectedSubscribers_ &&
+               acceptSubscriber(syncService, counts)) {
+        }
       }
 
-      std::cout << "✅ Все подписчики готовы, начинаем отправку" << std::endl;
+      if (items[1].revents & ZMQ_POLLIN) {
+        // Сообщение подписки: байт 1 (подписка) или 0 (отписка) и топик
+        zmq::message_t event;
+        while (publisher.recv(event, zmq::recv_flags::dontwait)) {
+          std::string_view data(static_cast<const char*>(event.data()),
+                                event.size());
+          if (!data.empty() && data[0] == 1 &&
+              data.substr(1) == protocol::TEXT_TOPIC) {
+            textSubscriptions++;
+          }
+        }
+      }
+    }
 
-      // Небольшая пауза для стабильности
-      std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    if (counts.ready == expectedSubscribers_ &&
+        textSubscriptions < counts.ready) {
+      std::cerr << "⚠️  Подписка дошла не от всех подписчиков" << std::endl;
+    }
+    return counts.ready == expectedSubscribers_;
+  }
 
-      // Сериализуем данные
-      std::string data = Serializer::serialize(studentsData_);
+  // Прием одного сигнала READY и ответ на него; false, если сообщений нет.
+  // Сообщение REQ приходит в ROUTER как идентификатор, пустой разделитель
+  // и тело; ответ отправляется с тем же конвертом
+  bool acceptSubscriber(zmq::socket_t& syncService, SubscriberCounts& counts) {
+    std::vector<zmq::message_t> envelope;
+    if (!recvRequest(syncService, envelope)) {
+      return false;
+    }
+    if (envelope.size() < 2) {
+      return true;
+    }
 
-      std::cout << "📤 Отправка данных (" << studentsData_.size()
-                << " студентов)..." << std::endl;
+    const zmq::message_t& message = envelope.back();
+    protocol::WireFormat format = protocol::parseFormat(std::string_view(
+        static_cast<const char*>(message.data()), message.size()));
+    // Публикуется один поток: при шардах — по топикам шардов, иначе
+    // целиком. Остальным подписчикам потока — двоичный формат целиком
+    if (format == protocol::WireFormat::Sharded && !sharding_.enabled()) {
+      format = protocol::WireFormat::Stream;
+    }
+    bool stream = format == protocol::WireFormat::Stream ||
+                  format == protocol::WireFormat::Sharded;
+    if ((format == protocol::WireFormat::Stream && sharding_.enabled()) ||
+        (stream && batchSize_ == 0) ||
+        (format == protocol::WireFormat::Shared && !sharedMemory_)) {
+      format = protocol::WireFormat::Binary;
+    }
+    if (format == protocol::WireFormat::Binary) {
+      counts.binary++;
+    } else if (format == protocol::WireFormat::Shared) {
+      counts.shared++;
+    } else if (format != protocol::WireFormat::Text) {
+      counts.stream++;
+    }
+
+    counts.ready++;
+    std::cout << "   Подписчик #" << counts.ready
+              << " готов (формат: " << protocol::formatName(format) << ")"
+              << std::endl;
+
+    // Отправляем подтверждение; подписчику шардов — вместе с составом
+    // публикации
+    sendEnvelope(syncService, envelope);
+    std::string ok = protocol::okMessage(format);
+    zmq::message_t reply(ok.data(), ok.size());
+    if (format != protocol::WireFormat::Sharded) {
+      syncService.send(reply, zmq::send_flags::none);
+      return true;
+    }
+    syncService.send(reply, zmq::send_flags::sndmore);
+    std::string manifest = streamShardLayout()->manifest.encode();
+    zmq::message_t manifestMessage(manifest.data(), manifest.size());
+    syncService.send(manifestMessage, zmq::send_flags::none);
+    return true;
+  }
+
+  // Раскладка списка по шардам: номера строк сгруппированы по шардам
+  // (шарды по возрастанию имени), пакеты не пересекают границ шардов
+  struct ShardLayout {
+    struct Batch {
+      uint32_t shard;
+      size_t first;  // диапазон в rows
+      size_t last;
+    };
 
-      int messagesSent = 0;
-      const int MAX_MESSAGES = 5;
+    std::vector<std::string> names;
+    std::vector<std::string> topics;
+    std::vector<uint32_t> rows;
+    std::vector<size_t> offsets;  // шард i — rows[offsets[i], offsets[i+1])
+    std::vector<Batch> batches;
+    protocol::ShardManifest manifest;
+  };
 
-      while (running_ && messagesSent < MAX_MESSAGES) {
-        // Отправляем топик и данные
-        zmq::message_t topic(8);
-        memcpy(topic.data(), "students", 8);
-        publisher.send(topic, zmq::send_flags::sndmore);
+  // Раскладка текущего списка по шардам. Строится при первом запросе и
+  // разделяется публикацией и снимками, как кеш сериализации
+  std::shared_ptr<const ShardLayout> shardLayout() {
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    if (layoutCache_ == nullptr) {
+      layoutCache_ = buildShardLayout(*studentsData_, streamId_);
+    }
+    return layoutCache_;
+  }
+
+  // Раскладка публикуемого списка (только поток публикации): из кеша, если
+  // список с тех пор не изменился, иначе строится заново
+  std::shared_ptr<const ShardLayout> streamShardLayout() {
+    if (streamLayout_ == nullptr) {
+      streamLayout_ = shardLayout();
+      if (streamLayout_->manifest.streamId != streamPublication_) {
+        streamLayout_ = buildShardLayout(*streamStudents_, streamPublication_);
+      }
+    }
+    return streamLayout_;
+  }
 
-        zmq::message_t message(data.size());
-        memcpy(message.data(), data.c_str(), data.size());
-        publisher.send(message, zmq::send_flags::none);
+  std::shared_ptr<const ShardLayout> buildShardLayout(
+      const std::vector<Student>& students, uint32_t streamId) const {
+    std::map<std::string, std::vector<uint32_t>> groups;
+    for (size_t i = 0; i < students.size(); ++i) {
+      groups[sharding_.shardOf(students[i])].push_back(
+          static_cast<uint32_t>(i));
+    }
 
-        messagesSent++;
-        std::cout << "   Сообщение " << messagesSent << "/" << MAX_MESSAGES
-                  << " отправлено" << std::endl;
+    auto layout = std::make_shared<ShardLayout>();
+    layout->rows.reserve(students.size());
+    layout->manifest.streamId = streamId;
+    layout->manifest.scheme = sharding_;
+    size_t batchSize = std::max<size_t>(batchSize_, 1);
+    for (auto& group : groups) {
+      uint32_t shard = static_cast<uint32_t>(layout->names.size());
+      size_t first = layout->rows.size();
+      layout->names.push_back(group.first);
+      layout->topics.push_back(protocol::shardTopic(group.first));
+      layout->offsets.push_back(first);
+      layout->rows.insert(layout->rows.end(), group.second.begin(),
+                          group.second.end());
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      protocol::ShardManifest::Shard entry;
+      entry.name = group.first;
+      entry.firstBatch = static_cast<uint32_t>(layout->batches.size());
+      entry.recordCount = static_cast<uint32_t>(group.second.size());
+      for (size_t row = first; row < layout->rows.size(); row += batchSize) {
+        layout->batches.push_back(
+            {shard, row, std::min(row + batchSize, layout->rows.size())});
       }
+      entry.batchCount =
+          static_cast<uint32_t>(layout->batches.size()) - entry.firstBatch;
+      layout->manifest.shards.push_back(std::move(entry));
+    }
+    layout->offsets.push_back(layout->rows.size());
+    return layout;
+  }
+
+  // Прием запроса из ROUTER без ожидания; false, если запросов нет.
+  // В envelope — все части: идентификатор, пустой разделитель (от REQ) и
+  // тело запроса последней частью
+  static bool recvRequest(zmq::socket_t& socket,
+                          std::vector<zmq::message_t>& envelope) {
+    envelope.clear();
+    zmq::message_t part;
+    if (!socket.recv(part, zmq::recv_flags::dontwait)) {
+      return false;
+    }
+    envelope.push_back(std::move(part));
+    while (envelope.back().more()) {
+      zmq::message_t next;
+      socket.recv(next, zmq::recv_flags::none);
+      envelope.push_back(std::move(next));
+    }
+    return true;
+  }
 
-      std::cout << "✅ Отправка завершена" << std::endl;
+  // Конверт ответа: все части запроса, кроме тела
+  static void sendEnvelope(zmq::socket_t& socket,
+                           std::vector<zmq::message_t>& envelope) {
+    for (size_t i = 0; i + 1 < envelope.size(); ++i) {
+      socket.send(envelope[i], zmq::send_flags::sndmore);
+    }
+  }
 
-      // Даем время доставить последнее сообщение
-      std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  // Сериализованный список в формате format (Text или Binary). Данные
+  // сериализуются при первом запросе и разделяются всеми отправками и
+  // снимками до следующего start() или изменений. streamId (если задан)
+  // получает номер публикации этого списка
+  Payload serialized(protocol::WireFormat format,
+                     uint32_t* streamId = nullptr) {
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    if (streamId != nullptr) {
+      *streamId = streamId_;
+    }
+    Payload& cache =
+        format == protocol::WireFormat::Text ? textCache_ : binaryCache_;
+    if (cache == nullptr) {
+      cache = std::make_shared<const std::string>(
+          format == protocol::WireFormat::Text
+              ? Serializer::serialize(*studentsData_)
+              : Serializer::serializeBinary(*studentsData_));
+    }
+    return cache;
+  }
+
+  // Поток сервиса снимков: отвечает на запросы SNAPSHOT, пока publisher не
+  // остановлен
+  void snapshotLoop() {
+    try {
+      std::shared_ptr<zmq::context_t> ownedContext = makeContext();
+      zmq::context_t& context = *ownedContext;
+      zmq::socket_t snapshotService(context, zmq::socket_type::router);
+      snapshotService.set(zmq::sockopt::linger, 0);
+      snapshotService.set(zmq::sockopt::backlog, MIN_BACKLOG);
+      snapshotService.bind(snapshotEndpoint_);
 
+      std::vector<zmq::message_t> envelope;
+      while (serving_) {
+        zmq::pollitem_t items[] = {
+            {snapshotService.handle(), 0, ZMQ_POLLIN, 0}};
+        zmq::poll(items, 1, POLL_INTERVAL);
+
+        while ((items[0].revents & ZMQ_POLLIN) &&
+               recvRequest(snapshotService, envelope)) {
+          if (envelope.size() >= 2) {
+            sendSnapshot(snapshotService, envelope);
+          }
+        }
+      }
     } catch (const zmq::error_t& e) {
-      std::cerr << "❌ ZMQ Synced Publisher ошибка: " << e.what() << std::endl;
+      std::cerr << "❌ ZMQ Snapshot Service ошибка: " << e.what()
+                << std::endl;
     }
+  }
 
-    running_ = false;
+  // Ответ на запрос снимка: формат, номер публикации и список. Список
+  // берется из кеша и отправляется без копирования
+  void sendSnapshot(zmq::socket_t& snapshotService,
+                    std::vector<zmq::message_t>& envelope) {
+    const zmq::message_t& request = envelope.back();
+    std::string_view requestText(static_cast<const char*>(request.data()),
+                                 request.size());
+    protocol::WireFormat format = protocol::parseFormat(requestText);
+    if (format != protocol::WireFormat::Text) {
+      format = protocol::WireFormat::Binary;
+    }
+
+    // Двоичный снимок шардов по схеме publisher собирается по запросу;
+    // иначе — весь список из кеша
+    protocol::ShardScheme scheme;
+    std::vector<std::string> shards;
+    uint32_t streamId;
+    Payload payload;
+    if (format == protocol::WireFormat::Binary && sharding_.enabled() &&
+        protocol::parseSnapshotShards(requestText, scheme, shards) &&
+        scheme == sharding_) {
+      payload = serializedShards(shards, streamId);
+    } else {
+      payload = serialized(format, &streamId);
+    }
+
+    sendEnvelope(snapshotService, envelope);
+    std::string ok = protocol::okMessage(format);
+    zmq::message_t reply(ok.data(), ok.size());
+    snapshotService.send(reply, zmq::send_flags::sndmore);
+    std::string id = std::to_string(streamId);
+    zmq::message_t idMessage(id.data(), id.size());
+    snapshotService.send(idMessage, zmq::send_flags::sndmore);
+    sendPayload(snapshotService, payload);
+
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    stats_.snapshots++;
+  }
+
+  // Описание сегмента общей памяти с текущим списком в двоичном формате
+  // (сегмент создается заново для каждой публикации из того же кеша
+  // сериализации). Если создать сегмент не удалось, в топике общей памяти
+  // публикуются сами данные: подписчик разберет их как двоичный формат
+  Payload sharedPayload() {
+    uint32_t streamId;
+    Payload binary = serialized(protocol::WireFormat::Binary, &streamId);
+
+    protocol::SharedDescriptor descriptor;
+    descriptor.name = "/students-" + std::to_string(::getpid()) + "-" +
+                      std::to_string(streamId);
+    descriptor.size = binary->size();
+    descriptor.streamId = streamId;
+    if (!segment_.create(descriptor.name, binary->data(), binary->size())) {
+      std::cerr << "⚠️  Не удалось создать сегмент общей памяти "
+                << descriptor.name << ": " << std::strerror(errno)
+                << ", данные отправляются целиком" << std::endl;
+      return binary;
+    }
+    return std::make_shared<const std::string>(descriptor.encode());
+  }
+
+  // Двоичный формат записей шардов shards текущего списка
+  Payload serializedShards(const std::vector<std::string>& shards,
+                           uint32_t& streamId) {
+    // Раскладка, список и номер берутся вместе: изменения могут заменить
+    // список между запросами
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    if (layoutCache_ == nullptr) {
+      layoutCache_ = buildShardLayout(*studentsData_, streamId_);
+    }
+    std::shared_ptr<const ShardLayout> layout = layoutCache_;
+    streamId = streamId_;
+
+    std::vector<uint32_t> rows;
+    for (const auto& shard : shards) {
+      auto name =
+          std::lower_bound(layout->names.begin(), layout->names.end(), shard);
+      if (name != layout->names.end() && *name == shard) {
+        size_t index = name - layout->names.begin();
+        rows.insert(rows.end(), layout->rows.begin() + layout->offsets[index],
+                    layout->rows.begin() + layout->offsets[index + 1]);
+      }
+    }
+    return std::make_shared<const std::string>(
+        Serializer::serializeBinaryRows(*studentsData_, rows.data(),
+                                        rows.size()));
+  }
+
+  // Число отправок текста и двоичного формата (и потока без канала
+  // восстановления)
+  static constexpr int MAX_SENDS = 5;
+  // Пауза между повторами и ожидание доставки последнего повтора
+  static constexpr std::chrono::milliseconds RESEND_INTERVAL{100};
+  static constexpr std::chrono::milliseconds DELIVERY_WAIT{500};
+  static constexpr std::chrono::milliseconds POLL_INTERVAL{100};
+  // Очередь подключений ZeroMQ по умолчанию
+  static constexpr int MIN_BACKLOG = 100;
+  static constexpr std::chrono::milliseconds ACK_TIMEOUT{1000};
+
+  // Число пакетов потока. Шардовый поток без записей пакетов не имеет
+  size_t batchCount() const {
+    if (streamLayout_ != nullptr) {
+      return streamLayout_->batches.size();
+    }
+    size_t count = (streamStudents_->size() + batchSize_ - 1) / batchSize_;
+    return std::max<size_t>(count, 1);
+  }
+
+  // Потоковая публикация: список уходит пакетами по batchSize_ записей.
+  // Пакет сериализуется непосредственно перед отправкой, поэтому
+  // сериализованный список целиком в памяти не хранится
+  void sendStream(zmq::socket_t& publisher) {
+    uint32_t count = static_cast<uint32_t>(batchCount());
+    for (uint32_t batch = 0; batch < count && running_; ++batch) {
+      sendTopic(publisher,
+                streamLayout_ != nullptr
+                    ? streamLayout_->topics[streamLayout_->batches[batch].shard]
+                    : protocol::STREAM_TOPIC);
+      sendBatch(publisher, batch);
+    }
+  }
+
+  // Заголовок и записи пакета batch (перед ними в сокет уже отправлен
+  // топик или идентификатор получателя). Возвращает размер записей
+  size_t sendBatch(zmq::socket_t& socket, uint32_t batch) {
+    const std::vector<Student>& students = *streamStudents_;
+
+    protocol::BatchHeader header;
+    header.streamId = streamPublication_;
+    header.sequence = batch;
+    header.batchCount = static_cast<uint32_t>(batchCount());
+    header.recordCount = static_cast<uint32_t>(students.size());
+    header.flags = batch + 1 == header.batchCount
+                       ? protocol::BatchHeader::FLAG_END_OF_STREAM
+                       : 0;
+
+    std::string encoded = header.encode();
+    zmq::message_t headerMessage(encoded.data(), encoded.size());
+    socket.send(headerMessage, zmq::send_flags::sndmore);
+
+    Payload payload;
+    if (streamLayout_ != nullptr) {
+      const ShardLayout::Batch& rows = streamLayout_->batches[batch];
+      payload = std::make_shared<const std::string>(
+          Serializer::serializeBinaryRows(
+              students, streamLayout_->rows.data() + rows.first,
+              rows.last - rows.first));
+    } else {
+      size_t first = static_cast<size_t>(batch) * batchSize_;
+      size_t last = std::min(first + batchSize_, students.size());
+      payload = std::make_shared<const std::string>(
+          Serializer::serializeBinary(students, first, last));
+    }
+    sendPayload(socket, payload);
+    return payload->size();
+  }
+
+  // Обслуживание канала восстановления, пока все подписчики потока не
+  // подтвердят прием. Пропущенные пакеты отправляются только запросившему
+  // подписчику. Если запросов и подтверждений нет дольше ACK_TIMEOUT (у
+  // подписчика могли пропасть все пакеты), поток повторяется целиком, но
+  // не больше MAX_SENDS раз. true — прием подтвердили все подписчики
+  bool awaitCompletion(zmq::socket_t& publisher, zmq::socket_t& repairService,
+                       int streamSubscribers) {
+    std::set<std::string> completed;
+    int sends = 1;
+    auto lastActivity = std::chrono::steady_clock::now();
+
+    while (running_ && static_cast<int>(completed.size()) < streamSubscribers) {
+      zmq::pollitem_t items[] = {{repairService.handle(), 0, ZMQ_POLLIN, 0}};
+      zmq::poll(items, 1, POLL_INTERVAL);
+
+      if ((items[0].revents & ZMQ_POLLIN) == 0) {
+        if (std::chrono::steady_clock::now() - lastActivity < ACK_TIMEOUT) {
+          continue;
+        }
+        if (sends == MAX_SENDS) {
+          std::cerr << "⚠️  Прием подтвердили " << completed.size() << " из "
+                    << streamSubscribers << " подписчиков" << std::endl;
+          break;
+        }
+        sendStream(publisher);
+        sends++;
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        stats_.streamResends++;
+        lastActivity = std::chrono::steady_clock::now();
+        continue;
+      }
+
+      zmq::message_t identity;
+      zmq::message_t body;
+      if (!repairService.recv(identity, zmq::recv_flags::none) ||
+          !identity.more() ||
+          !repairService.recv(body, zmq::recv_flags::none)) {
+        continue;
+      }
+      lastActivity = std::chrono::steady_clock::now();
+
+      protocol::RepairRequest request;
+      if (!protocol::parseRepairRequest(
+              std::string_view(static_cast<const char*>(body.data()),
+                               body.size()),
+              request) ||
+          request.streamId != streamPublication_) {
+        continue;
+      }
+
+      if (request.done) {
+        std::string peer(static_cast<const char*>(identity.data()),
+                         identity.size());
+        if (completed.insert(peer).second) {
+          std::cout << "   Подписчик подтвердил прием (" << completed.size()
+                    << "/" << streamSubscribers << ")" << std::endl;
+          std::lock_guard<std::mutex> lock(statsMutex_);
+          stats_.completedSubscribers = static_cast<int>(completed.size());
+        }
+        continue;
+      }
+
+      retransmit(repairService, identity, request);
+    }
+
+    DeliveryStats stats = deliveryStats();
+    std::cout << "🔁 NACK: " << stats.nacks << ", повторно отправлено пакетов: "
+              << stats.retransmittedBatches << " ("
+              << stats.retransmittedBytes << " байт), повторов потока: "
+              << stats.streamResends << std::endl;
+    return static_cast<int>(completed.size()) == streamSubscribers;
+  }
+
+  // Отправка пакетов request.first..request.last одному подписчику
+  void retransmit(zmq::socket_t& repairService, const zmq::message_t& identity,
+                  const protocol::RepairRequest& request) {
+    uint32_t count = static_cast<uint32_t>(batchCount());
+    if (count == 0) {
+      return;
+    }
+    uint32_t last = std::min(request.last, count - 1);
+
+    size_t batches = 0;
+    size_t bytes = 0;
+    for (uint32_t batch = request.first; batch <= last && running_; ++batch) {
+      zmq::message_t peer(identity.data(), identity.size());
+      repairService.send(peer, zmq::send_flags::sndmore);
+      bytes += sendBatch(repairService, batch);
+      batches++;
+    }
+
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    stats_.nacks++;
+    stats_.retransmittedBatches += batches;
+    stats_.retransmittedBytes += bytes;
+  }
+
+  static void sendData(zmq::socket_t& publisher, std::string_view topicName,
+                       const Payload& payload) {
+    sendTopic(publisher, topicName);
+    sendPayload(publisher, payload);
+  }
+
+  static void sendTopic(zmq::socket_t& publisher, std::string_view topicName) {
+    zmq::message_t topic(topicName.size());
+    memcpy(topic.data(), topicName.data(), topicName.size());
+    publisher.send(topic, zmq::send_flags::sndmore);
+  }
+
+  // Отправка без копирования: сообщение ссылается на байты payload и
+  // держит свою ссылку на него, ZeroMQ освобождает ее, когда сообщение
+  // отправлено всем подписчикам
+  static void sendPayload(zmq::socket_t& publisher, const Payload& payload,
+                          zmq::send_flags flags = zmq::send_flags::none) {
+    auto* reference = new Payload(payload);
+    zmq::message_t message(const_cast<char*>(payload->data()),
+                           payload->size(), releasePayload, reference);
+    publisher.send(message, flags);
+  }
+
+  static void releasePayload(void* /*data*/, void* hint) {
+    delete static_cast<Payload*>(hint);
   }
 
   std::string pubEndpoint_;
   std::string syncEndpoint_;
   std::atomic<bool> running_;
   std::thread publishThread_;
-  std::vector<Student> studentsData_;
+  // Список, номер публикации и кеш сериализации; сервис снимков читает их
+  // из своего потока под dataMutex_
+  std::shared_ptr<const std::vector<Student>> studentsData_;
+  Payload textCache_;
+  Payload binaryCache_;
+  std::shared_ptr<const ShardLayout> layoutCache_;
+  // Список потоковой публикации, его номер и раскладка по шардам (только
+  // поток публикации); streamLayout_ == nullptr — поток без шардов.
+  // Изменения, принятые во время публикации, меняют studentsData_, но не
+  // публикуемый список
+  std::shared_ptr<const std::vector<Student>> streamStudents_;
+  uint32_t streamPublication_ = 0;
+  std::shared_ptr<const ShardLayout> streamLayout_;
+  protocol::ShardScheme sharding_;
+  bool sharedMemory_ = false;
+  // Сегмент общей памяти текущей публикации (только поток публикации)
+  SharedSegment segment_;
+  std::shared_ptr<zmq::context_t> context_;
+  std::mutex dataMutex_;
   int expectedSubscribers_;
+  size_t batchSize_ = DEFAULT_BATCH_SIZE;
+  std::string repairEndpoint_;
+  std::string snapshotEndpoint_;
+  std::thread snapshotThread_;
+  std::atomic<bool> serving_{false};
+  std::chrono::milliseconds syncTimeout_{0};
+  bool liveUpdates_ = false;
+  std::deque<PendingUpdate> pendingUpdates_;
+  std::mutex updatesMutex_;
+  std::condition_variable updatesReady_;
+  DeliveryStats stats_;
+  mutable std::mutex statsMutex_;
+  // Номер публикации в BatchHeader: подписчик не смешивает пакеты разных
+  // публикаций
+  uint32_t streamId_ = 0;
 };
\ No newline at end of file
@@ -1,12 +1,27 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
 #include <iomanip>
 #include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
+#include "../common/Endpoints.h"
 #include "../common/Student.h"
+#include "ExternalMerger.h"
 #include "FileParser.h"
+#include "FileWatcher.h"
+#include "IncrementalMerger.h"
 #include "StudentMerger.h"
+#include "StudentQueryService.h"
 #include "ZmqSyncedPublisher.h"
 
-int main() {
+// Ожидание подписчиков с --watch по умолчанию, секунды
+constexpr long WATCH_SYNC_TIMEOUT = 10;
+
+int main(int argc, char* argv[]) {
   std::cout << "╔════════════════════════════════════════════════════╗"
             << std::endl;
   std::cout << "║          СЕРВЕР УПРАВЛЕНИЯ СТУДЕНТАМИ              ║"
@@ -15,51 +30,199 @@ int main() {
             << std::endl;
   std::cout << std::endl;
 
-  // Шаг 1: Чтение файлов
-  std::cout << "📖 ШАГ 1: Чтение файлов со студентами\n" << std::endl;
-
-  auto students1 = FileParser::parseFile("student_file_1.txt");
-  auto students2 = FileParser::parseFile("student_file_2.txt");
-
-  if (students1.empty() && students2.empty()) {
-    std::cerr << "\n❌ Ошибка: Не удалось загрузить данные студентов"
+  // Входные файлы и каталоги из аргументов, по умолчанию — два файла.
+  // --watch: сервер следит за файлами и публикует изменения списка.
+  // --shard=<ключ>[:<ширина>]: поток разбивается на шарды по первой букве
+  // фамилии (initial), году рождения (year) или диапазону ID (id).
+  // --transport=tcp[:<хост>]|ipc[:<каталог>]: транспорт (по умолчанию tcp).
+  // --shm: клиенты на этой машине получают список через общую память.
+  // --memory-budget=<МБ>: объединение с ограничением памяти (временные
+  // файлы при превышении), без --watch.
+  // --subscribers=<N>: сколько подписчиков ждать перед публикацией (по
+  // умолчанию 2; 0 — список выдается только снимками).
+  // --sync-timeout=<с>: сколько ждать подписчиков; по истечении список
+  // публикуется подключившимся, остальные получают снимок (по умолчанию
+  // ждать всех, с --watch — WATCH_SYNC_TIMEOUT: изменения отправляются
+  // после публикации списка)
+  std::vector<std::string> inputs;
+  bool watch = false;
+  size_t memoryBudget = 0;
+  int expectedSubscribers = 2;
+  long syncTimeoutSeconds = -1;
+  bool sharedMemory = false;
+  protocol::ShardScheme sharding;
+  Endpoints endpoints;
+  Endpoints::forServer("tcp", endpoints);
+  for (int i = 1; i < argc; ++i) {
+    std::string argument = argv[i];
+    if (argument == "--watch") {
+      watch = true;
+    } else if (argument == "--shm") {
+      sharedMemory = true;
+    } else if (argument.rfind("--transport=", 0) == 0) {
+      // inproc:// работает только внутри процесса, клиенты — отдельные
+      // процессы
+      std::string transport = argument.substr(12);
+      if (transport == "inproc" ||
+          !Endpoints::forServer(transport, endpoints)) {
+        std::cerr << "❌ Неподдерживаемый транспорт: " << transport
+                  << std::endl;
+        return 1;
+      }
+    } else if (argument.rfind("--memory-budget=", 0) == 0) {
+      char* end = nullptr;
+      unsigned long megabytes = std::strtoul(argument.c_str() + 16, &end, 10);
+      if (megabytes == 0 || *end != '\0') {
+        std::cerr << "❌ Неверный бюджет памяти: " << argument << std::endl;
+        return 1;
+      }
+      memoryBudget = static_cast<size_t>(megabytes) << 20;
+    } else if (argument.rfind("--subscribers=", 0) == 0) {
+      char* end = nullptr;
+      long count = std::strtol(argument.c_str() + 14, &end, 10);
+      if (count < 0 || *end != '\0' || end == argument.c_str() + 14) {
+        std::cerr << "❌ Неверное число подписчиков: " << argument
+                  << std::endl;
+        return 1;
+      }
+      expectedSubscribers = static_cast<int>(count);
+    } else if (argument.rfind("--sync-timeout=", 0) == 0) {
+      char* end = nullptr;
+      syncTimeoutSeconds = std::strtol(argument.c_str() + 15, &end, 10);
+      if (syncTimeoutSeconds < 0 || *end != '\0' ||
+          end == argument.c_str() + 15) {
+        std::cerr << "❌ Неверное время ожидания: " << argument << std::endl;
+        return 1;
+      }
+    } else if (argument.rfind("--shard=", 0) == 0) {
+      if (!protocol::ShardScheme::fromOption(argument.substr(8), sharding)) {
+        std::cerr << "❌ Неизвестная схема шардов: " << argument << std::endl;
+        return 1;
+      }
+    } else {
+      inputs.push_back(argument);
+    }
+  }
+  if (inputs.empty()) {
+    inputs = {"student_file_1.txt", "student_file_2.txt"};
+  }
+  if (syncTimeoutSeconds < 0) {
+    syncTimeoutSeconds = watch ? WATCH_SYNC_TIMEOUT : 0;
+  }
+  // Повторное объединение измененных файлов хранит все записи в памяти
+  if (watch && memoryBudget > 0) {
+    std::cerr << "⚠️  --memory-budget не действует вместе с --watch"
               << std::endl;
-    return 1;
+    memoryBudget = 0;
   }
 
-  // Шаг 2: Объединение студентов
-  std::cout << "\n📖 ШАГ 2: Объединение списков студентов" << std::endl;
-  auto mergedStudents = StudentMerger::mergeStudents(students1, students2);
+  // Шаг 1: Чтение и объединение файлов
+  std::cout << "📖 ШАГ 1: Чтение и объединение файлов со студентами"
+            << std::endl;
+
+  // В режиме наблюдения записи файлов сохраняются: при изменении
+  // разбираются только изменившиеся файлы
+  IncrementalMerger incrementalMerger(inputs);
+  std::shared_ptr<const std::vector<Student>> mergedStudents;
+  if (watch) {
+    mergedStudents = incrementalMerger.load();
+  } else if (memoryBudget > 0) {
+    mergedStudents = std::make_shared<const std::vector<Student>>(
+        ExternalMerger::mergeFiles(inputs, memoryBudget));
+  } else {
+    mergedStudents = std::make_shared<const std::vector<Student>>(
+        StudentMerger::mergeFiles(inputs));
+  }
 
-  if (mergedStudents.empty()) {
-    std::cerr << "\n❌ Ошибка: Нет студентов для отправки" << std::endl;
+  if (mergedStudents->empty()) {
+    std::cerr << "\n❌ Ошибка: Не удалось загрузить данные студентов"
+              << std::endl;
     return 1;
   }
 
   // Вывод объединенного списка для проверки
   std::cout << "\n📋 Объединенный список студентов:" << std::endl;
   std::cout << std::string(70, '-') << std::endl;
-  for (const auto& student : mergedStudents) {
+  for (const auto& student : *mergedStudents) {
     std::cout << student.toString() << std::endl;
   }
   std::cout << std::string(70, '-') << std::endl;
 
-  // Шаг 3: Публикация через ZeroMQ
-  std::cout << "\n📖 ШАГ 3: Публикация данных через ZeroMQ\n" << std::endl;
-
-  ZmqSyncedPublisher publisher("tcp://*:5555", "tcp://*:5556");
-
-  // Запускаем публикацию в отдельном потоке, ожидаем 2-х клиентов
-  publisher.start(mergedStudents, 2);
+  // Шаг 2: Публикация через ZeroMQ
+  std::cout << "\n📖 ШАГ 2: Публикация данных через ZeroMQ\n" << std::endl;
+
+  ZmqSyncedPublisher publisher(endpoints.pub, endpoints.sync);
+  // Канал восстановления: поток отправляется один раз, подписчики
+  // запрашивают только пропущенные пакеты
+  publisher.setRepairEndpoint(endpoints.repair);
+  // Сервис снимков: клиент, опоздавший к публикации, получает весь список
+  // по запросу, пока сервер работает
+  publisher.setSnapshotEndpoint(endpoints.snapshot);
+  publisher.setLiveUpdates(watch);
+  publisher.setSyncTimeout(std::chrono::seconds(syncTimeoutSeconds));
+  publisher.setSharding(sharding);
+  publisher.setSharedMemory(sharedMemory);
+
+  // Сервис запросов: поиск студентов по ID, ФИО и дате рождения без
+  // рассылки всего списка
+  StudentQueryService queryService(endpoints.query);
+  queryService.start(mergedStudents);
+
+  // Запускаем публикацию в отдельном потоке, ожидаем expectedSubscribers
+  // клиентов. Список передается publisher без копирования
+  publisher.start(std::move(mergedStudents), expectedSubscribers);
+
+  // Наблюдение за файлами: после изменения публикуются только изменения
+  // списка
+  std::atomic<bool> watching(watch);
+  std::thread watcher;
+  if (watch) {
+    watcher = std::thread([&] {
+      FileWatcher files(inputs);
+      if (!files.isOpen()) {
+        std::cerr << "❌ Наблюдение за файлами недоступно, изменения не "
+                     "публикуются"
+                  << std::endl;
+        return;
+      }
+      while (watching) {
+        std::vector<std::string> changed =
+            files.wait(std::chrono::milliseconds(100));
+        if (changed.empty()) {
+          continue;
+        }
+
+        std::cout << "\n📝 Изменены входные данные" << std::endl;
+        StudentDelta delta;
+        auto students = incrementalMerger.reload(changed, delta);
+        if (delta.empty()) {
+          std::cout << "   Список студентов не изменился" << std::endl;
+          continue;
+        }
+        queryService.update(students);
+        publisher.publishDelta(std::move(students), std::move(delta));
+      }
+    });
+  }
 
   // Ждем завершения публикации
   std::cout << "\n⏳ Ожидание завершения публикации..." << std::endl;
+  if (watch) {
+    std::cout << "   Изменения файлов публикуются по мере появления"
+              << std::endl;
+  }
   std::cout << "   (Нажмите Enter для завершения работы сервера)" << std::endl;
 
   std::cin.get();
 
+  watching = false;
+  if (watcher.joinable()) {
+    watcher.join();
+  }
+
   // Останавливаем publisher
   publisher.stop();
+  queryService.stop();
 
   std::cout << "\n✅ Сервер завершил работу" << std::endl;
 
@@ -71,5 +234,8 @@ int main() {
  * g++ -std=c++17 server_main.cpp -o server -lzmq -pthread
  *
  * Запуск:
- * ./server
+ * ./server [--watch] [--shard=initial|year|id[:ширина]] [--shm]
+ *          [--memory-budget=МБ] [--subscribers=N] [--sync-timeout=с]
+ *          [--transport=tcp[:хост]|ipc[:каталог]]
+ *          [файлы или каталоги со студентами...]
  */
\ No newline at end of file
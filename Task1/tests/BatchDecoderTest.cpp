@@ -0,0 +1,79 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <zmq.hpp>
+
+#include "../client/BatchDecoder.h"
+#include "../common/Serializer.h"
+#include "Check.h"
+#include "Rosters.h"
+
+// Разбор пакетов в пуле потоков: снимок собирается в порядке передачи при
+// любом числе потоков, в том числе когда медленный обработчик записей
+// заполняет очереди и поток приема ждет места
+namespace {
+
+std::vector<zmq::message_t> makeBatches(const std::vector<Student>& students,
+                                        size_t batchSize) {
+  std::vector<zmq::message_t> batches;
+  for (size_t first = 0; first < students.size(); first += batchSize) {
+    size_t last = std::min(first + batchSize, students.size());
+    std::string bytes = Serializer::serializeBinary(students, first, last);
+    batches.emplace_back(bytes.data(), bytes.size());
+  }
+  return batches;
+}
+
+void checkDecoder(unsigned threads, bool slowHandler) {
+  BatchDecoder decoder(threads);
+  std::atomic<size_t> handled{0};
+  decoder.setRecordHandler([&](const std::vector<StudentView>& views) {
+    handled += views.size();
+    if (slowHandler) {
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+  });
+
+  // Несколько публикаций подряд; пакетов больше, чем вмещают все очереди
+  const size_t batchCounts[] = {
+      0, 1, BatchDecoder::QUEUE_CAPACITY,
+      BatchDecoder::QUEUE_CAPACITY * 4 * std::max(threads, 4u)};
+  for (size_t batchCount : batchCounts) {
+    std::vector<Student> students = test::randomRoster(
+        batchCount * 7, static_cast<uint32_t>(batchCount + threads));
+    std::vector<zmq::message_t> batches = makeBatches(students, 7);
+
+    handled = 0;
+    decoder.begin(batches.size());
+    for (auto& batch : batches) {
+      decoder.push(std::move(batch));
+    }
+    CHECK(decoder.pushed() == batches.size());
+    StudentSnapshot snapshot = decoder.finish();
+    CHECK(test::sameRoster(snapshot.toStudents(), students));
+    CHECK(handled == students.size());
+  }
+
+  // Пакеты сверх объявленного числа не принимаются
+  std::vector<Student> students = test::randomRoster(14, 1);
+  std::vector<zmq::message_t> batches = makeBatches(students, 7);
+  decoder.begin(1);
+  for (auto& batch : batches) {
+    decoder.push(std::move(batch));
+  }
+  CHECK(decoder.pushed() == 1);
+  CHECK(decoder.finish().size() == 7);
+}
+
+}  // namespace
+
+int main() {
+  for (unsigned threads : {1u, 2u, 3u, 0u}) {
+    checkDecoder(threads, false);
+    checkDecoder(threads, true);
+  }
+  return test::finish("BatchDecoderTest");
+}
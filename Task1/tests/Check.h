@@ -0,0 +1,61 @@
+#pragma once
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// Проверки для тестов (make test). Тест — отдельная программа: CHECK
+// сообщает о нарушенном условии и продолжает работу, test::finish()
+// подводит итог и возвращает код завершения для main
+namespace test {
+
+inline int& failures() {
+  static int count = 0;
+  return count;
+}
+
+inline void fail(const char* file, int line, const char* condition) {
+  std::cerr << "❌ " << file << ":" << line << ": " << condition
+            << std::endl;
+  failures()++;
+}
+
+inline int finish(const char* name) {
+  if (failures() == 0) {
+    std::cout << "✅ " << name << std::endl;
+    return 0;
+  }
+  std::cerr << "❌ " << name << ": нарушено проверок: " << failures()
+            << std::endl;
+  return 1;
+}
+
+// Подавление вывода в stream (по умолчанию std::cout) на время жизни
+// объекта: проверяемый код подробно сообщает о ходе работы, тесту нужны
+// только результаты
+class QuietOutput {
+ public:
+  explicit QuietOutput(std::ostream& stream = std::cout)
+      : stream_(stream), previous_(stream.rdbuf(sink_.rdbuf())) {}
+  ~QuietOutput() { stream_.rdbuf(previous_); }
+
+  QuietOutput(const QuietOutput&) = delete;
+  QuietOutput& operator=(const QuietOutput&) = delete;
+
+  // Подавленный вывод
+  std::string text() const { return sink_.str(); }
+
+ private:
+  std::ostringstream sink_;
+  std::ostream& stream_;
+  std::streambuf* previous_;
+};
+
+}  // namespace test
+
+#define CHECK(condition)                           \
+  do {                                             \
+    if (!(condition)) {                            \
+      test::fail(__FILE__, __LINE__, #condition);  \
+    }                                              \
+  } while (false)
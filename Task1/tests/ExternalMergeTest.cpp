@@ -0,0 +1,87 @@
+#include <string>
+#include <vector>
+
+#include "../server/ExternalMerger.h"
+#include "../server/StudentMerger.h"
+#include "Check.h"
+#include "Rosters.h"
+
+// Объединение с бюджетом памяти против объединения в памяти
+namespace {
+
+std::vector<std::string> writeFiles(
+    const test::TempDir& directory,
+    const std::vector<std::vector<Student>>& lists) {
+  std::vector<std::string> files;
+  for (size_t i = 0; i < lists.size(); ++i) {
+    files.push_back(directory.file("students_" + std::to_string(i) + ".txt"));
+    test::writeRoster(files.back(), lists[i]);
+  }
+  return files;
+}
+
+// Бюджеты от «все в памяти» до сброса во временные файлы почти сразу
+void checkBudgets() {
+  test::QuietOutput quiet;
+  test::TempDir directory("external-merge-test");
+  std::vector<std::vector<Student>> lists = {
+      test::randomRoster(20000, 1, 1, 3000),
+      test::randomRoster(20000, 2, 20001, 3000)};
+  std::vector<std::string> files = writeFiles(directory, lists);
+  std::vector<Student> expected = StudentMerger::mergeFiles(files);
+
+  for (size_t budget : {size_t(256) << 20, size_t(1) << 20, size_t(256) << 10,
+                        size_t(64) << 10}) {
+    CHECK(test::sameRoster(ExternalMerger::mergeFiles(files, budget),
+                           expected));
+  }
+}
+
+// Первый файл почти из одних дубликатов: по нему прогноз занижает память
+// остальных, и разделы не помещаются в бюджет — они делятся на подразделы
+void checkSplit() {
+  test::QuietOutput quiet;
+  test::TempDir directory("external-split-test");
+  std::vector<std::vector<Student>> lists = {
+      test::randomRoster(30000, 3, 1, 2),
+      test::randomRoster(40000, 4, 30001, 10000),
+      test::randomRoster(40000, 5, 70001, 10000)};
+  std::vector<std::string> files = writeFiles(directory, lists);
+  std::vector<Student> expected = StudentMerger::mergeFiles(files);
+
+  std::vector<Student> merged =
+      ExternalMerger::mergeFiles(files, size_t(512) << 10);
+  CHECK(test::sameRoster(merged, expected));
+  CHECK(quiet.text().find("подразделов") != std::string::npos);
+}
+
+// Ошибка временных файлов: пустой результат вместо части списка
+void checkFailure() {
+  test::QuietOutput quiet;
+  test::TempDir directory("external-fail-test");
+  std::vector<std::string> files =
+      writeFiles(directory, {test::randomRoster(20000, 6, 1, 3000)});
+
+  std::string missing = directory.file("missing/nested");
+  size_t consumed = 0;
+  bool merged;
+  std::vector<Student> mergedList;
+  {
+    test::QuietOutput quietErrors(std::cerr);
+    merged = ExternalMerger::mergeFiles(
+        files, size_t(64) << 10, [&](Student&&) { consumed++; }, missing);
+    mergedList = ExternalMerger::mergeFiles(files, size_t(64) << 10, missing);
+  }
+  CHECK(!merged);
+  CHECK(consumed == 0);
+  CHECK(mergedList.empty());
+}
+
+}  // namespace
+
+int main() {
+  checkBudgets();
+  checkSplit();
+  checkFailure();
+  return test::finish("ExternalMergeTest");
+}
@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "../common/StudentTable.h"
+#include "../server/FileParser.h"
+#include "../server/StudentMerger.h"
+#include "Check.h"
+#include "Rosters.h"
+
+// Варианты объединения против последовательного mergeStudents: тот же
+// состав, те же ID и (где обещан) тот же порядок
+namespace {
+
+// Последовательное объединение списков по порядку
+std::vector<Student> serialMerge(
+    const std::vector<std::vector<Student>>& lists) {
+  std::vector<Student> merged;
+  for (const auto& list : lists) {
+    merged = StudentMerger::mergeStudents(merged, list, false);
+  }
+  return merged;
+}
+
+std::vector<Student> sortedByKey(std::vector<Student> students) {
+  std::sort(students.begin(), students.end(),
+            [](const Student& a, const Student& b) {
+              return a.getUniqueKey() < b.getUniqueKey();
+            });
+  return students;
+}
+
+// Списки с дубликатами внутри и между списками; последний список повторяет
+// часть ID первого (ID объединенной записи не повторяются)
+std::vector<std::vector<Student>> makeLists(size_t listCount, size_t size,
+                                            uint32_t seed) {
+  std::vector<std::vector<Student>> lists;
+  for (size_t i = 0; i < listCount; ++i) {
+    lists.push_back(test::randomRoster(
+        size, seed + static_cast<uint32_t>(i),
+        1 + static_cast<int>(i * size), 60));
+  }
+  if (listCount > 1) {
+    lists.back().insert(lists.back().end(), lists[0].begin(),
+                        lists[0].begin() + size / 3);
+  }
+  return lists;
+}
+
+void checkParallel() {
+  for (size_t listCount : {1, 2, 5}) {
+    for (size_t size : {0, 1, 50, 3000}) {
+      auto lists = makeLists(listCount, size, 7);
+      std::vector<Student> expected = serialMerge(lists);
+
+      for (unsigned shards : {1u, 2u, 3u, 8u, 0u}) {
+        std::vector<ShardStats> stats;
+        std::vector<Student> firstSeen = StudentMerger::mergeStudentsParallel(
+            lists, shards, MergeOrder::FirstSeen, &stats);
+        CHECK(test::sameRoster(firstSeen, expected));
+
+        std::vector<Student> byShard = StudentMerger::mergeStudentsParallel(
+            lists, shards, MergeOrder::ByShard);
+        CHECK(test::sameRoster(sortedByKey(byShard), sortedByKey(expected)));
+
+        size_t records = 0;
+        size_t unique = 0;
+        for (const auto& shard : stats) {
+          records += shard.records;
+          unique += shard.unique;
+        }
+        size_t total = 0;
+        for (const auto& list : lists) {
+          total += list.size();
+        }
+        CHECK(records == total);
+        CHECK(unique == expected.size());
+      }
+    }
+  }
+}
+
+void checkTables() {
+  auto lists = makeLists(2, 3000, 11);
+  std::vector<Student> expected = serialMerge(lists);
+
+  // Таблицы с разными пулами (имена второй переводятся в пул первой) и с
+  // общим пулом
+  StudentTable first = StudentTable::fromStudents(lists[0]);
+  StudentTable second = StudentTable::fromStudents(lists[1]);
+  CHECK(test::sameRoster(first.toStudents(), lists[0]));
+  CHECK(test::sameRoster(
+      StudentMerger::mergeStudents(first, second, false).toStudents(),
+      expected));
+
+  StudentTable shared =
+      StudentTable::fromStudents(lists[1], first.sharedPool());
+  CHECK(test::sameRoster(
+      StudentMerger::mergeStudents(first, shared, false).toStudents(),
+      expected));
+
+  // Таблица, объединенная сама с собой, не меняет ID строк
+  std::vector<Student> once = serialMerge({lists[0]});
+  CHECK(test::sameRoster(
+      StudentMerger::mergeStudents(first, first, false).toStudents(), once));
+}
+
+// Разбор файла в таблицу и объединение файлов сервером — против разбора в
+// Student и последовательного объединения
+void checkFiles() {
+  test::TempDir directory("merge-test");
+  auto lists = makeLists(3, 2000, 23);
+  std::vector<std::string> files;
+  std::vector<std::vector<Student>> parsed;
+  for (size_t i = 0; i < lists.size(); ++i) {
+    files.push_back(directory.file("students_" + std::to_string(i) + ".txt"));
+    test::writeRoster(files.back(), lists[i]);
+    parsed.push_back(FileParser::parseFile(files.back()));
+    CHECK(test::sameRoster(parsed.back(), lists[i]));
+    CHECK(test::sameRoster(
+        FileParser::parseFileTable(files.back()).toStudents(), lists[i]));
+  }
+
+  std::vector<Student> expected = serialMerge(parsed);
+  CHECK(test::sameRoster(StudentMerger::mergeFiles(files), expected));
+  CHECK(test::sameRoster(
+      StudentMerger::mergeStudentsParallel(parsed, 4, MergeOrder::FirstSeen),
+      expected));
+}
+
+}  // namespace
+
+int main() {
+  {
+    test::QuietOutput quiet;
+    checkParallel();
+    checkTables();
+    checkFiles();
+  }
+  return test::finish("MergeTest");
+}
@@ -0,0 +1,109 @@
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include "../common/NameScan.h"
+#include "Check.h"
+
+namespace {
+
+// Прежняя проверка имени на std::regex (побайтовая)
+bool legacyName(const std::string& name) {
+  static const std::regex namePattern("^[A-Za-zА-Яа-яЁё]+$");
+  return std::regex_match(name, namePattern);
+}
+
+// Все реализации, доступные на этом процессоре
+std::vector<name_scan::Kernel> kernels() {
+  std::vector<name_scan::Kernel> result = {name_scan::scalar};
+#ifdef NAME_SCAN_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("sse2")) {
+    result.push_back(name_scan::sse2);
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    result.push_back(name_scan::avx2);
+  }
+#endif
+  return result;
+}
+
+void checkBytes(const std::vector<name_scan::Kernel>& all, const char* data,
+                size_t size) {
+  bool expected = name_scan::scalar(data, size);
+  for (name_scan::Kernel kernel : all) {
+    CHECK(kernel(data, size) == expected);
+  }
+}
+
+// Каждый байт отдельно: тот же набор, что у регулярного выражения
+void checkTable(const std::vector<name_scan::Kernel>& all) {
+  for (int c = 1; c < 256; ++c) {
+    std::string name(1, static_cast<char>(c));
+    CHECK(name_scan::scalar(name.data(), name.size()) == legacyName(name));
+    checkBytes(all, name.data(), name.size());
+  }
+}
+
+// Строки всех длин до 100 и всех смещений в блоке из допустимых байтов с
+// одним недопустимым в случайном месте (или без него)
+void checkRandom(const std::vector<name_scan::Kernel>& all) {
+  const std::string valid =
+      "AZaz\x81\x8F\x90\xA0\xB0\xC0\xD0\xD1"
+      "Ivan"
+      "Иван";
+  const std::string invalid = std::string(" 0.-_\x7F\x80\xD2\xFF", 9) +
+                              std::string(1, '\0');
+  std::mt19937 random(42);
+  std::vector<char> buffer(256);
+  for (size_t size = 0; size <= 100; ++size) {
+    for (size_t offset = 0; offset < 32; ++offset) {
+      char* data = buffer.data() + offset;
+      for (size_t i = 0; i < size; ++i) {
+        data[i] = valid[random() % valid.size()];
+      }
+      checkBytes(all, data, size);
+      if (size > 0) {
+        data[random() % size] = invalid[random() % invalid.size()];
+        checkBytes(all, data, size);
+        std::string name(data, size);
+        CHECK(name_scan::scalar(data, size) == legacyName(name));
+      }
+    }
+  }
+}
+
+// Строка, кончающаяся у границы страницы, за которой чтение запрещено:
+// хвост не должен читаться за концом строки
+void checkPageEnd(const std::vector<name_scan::Kernel>& all) {
+  size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+  void* mapped = ::mmap(nullptr, 2 * page, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  CHECK(mapped != MAP_FAILED);
+  if (mapped == MAP_FAILED) {
+    return;
+  }
+  char* guard = static_cast<char*>(mapped) + page;
+  CHECK(::mprotect(guard, page, PROT_NONE) == 0);
+  for (size_t size = 0; size <= 64; ++size) {
+    char* data = guard - size;
+    std::memset(data, 'a', size);
+    checkBytes(all, data, size);
+  }
+  ::munmap(mapped, 2 * page);
+}
+
+}  // namespace
+
+int main() {
+  std::vector<name_scan::Kernel> all = kernels();
+  checkTable(all);
+  checkRandom(all);
+  checkPageEnd(all);
+  return test::finish("NameScanTest");
+}
@@ -0,0 +1,189 @@
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../server/FileParser.h"
+#include "Check.h"
+#include "Rosters.h"
+
+// Разбор файла через отображение в память, в нескольких потоках и окнами
+// против построчного parseFile: те же записи, те же сообщения об ошибках
+// и та же сводка
+namespace {
+
+// Результат разбора: записи и весь вывод (сообщения и сводка)
+struct Parsed {
+  std::vector<Student> students;
+  std::string output;
+  std::string errors;
+};
+
+template <typename Parse>
+Parsed capture(Parse parse) {
+  Parsed parsed;
+  test::QuietOutput output;
+  test::QuietOutput errors(std::cerr);
+  parsed.students = parse();
+  parsed.output = output.text();
+  parsed.errors = errors.text();
+  return parsed;
+}
+
+bool sameParse(const Parsed& a, const Parsed& b) {
+  return test::sameRoster(a.students, b.students) && a.output == b.output &&
+         a.errors == b.errors;
+}
+
+Parsed streamed(const std::string& path, size_t windowSize) {
+  return capture([&] {
+    std::vector<Student> students;
+    FileParser::streamFile(
+        path, windowSize,
+        [&](const std::vector<StudentRecordView>& records,
+            std::string_view) {
+          for (const auto& record : records) {
+            students.push_back(record.materialize());
+          }
+          return true;
+        });
+    return students;
+  });
+}
+
+// Все варианты разбора файла path против parseFile
+void checkFile(const std::string& path) {
+  Parsed expected = capture([&] { return FileParser::parseFile(path); });
+
+  CHECK(sameParse(
+      capture([&] { return FileParser::parseFileMapped(path); }), expected));
+  CHECK(sameParse(
+      capture([&] { return FileParser::mapFile(path).materialize(); }),
+      expected));
+  for (unsigned threads : {1u, 2u, 3u, 8u, 0u}) {
+    CHECK(sameParse(capture([&] {
+                      return FileParser::parseFileParallel(path, threads);
+                    }),
+                    expected));
+    CHECK(sameParse(capture([&] {
+                      return FileParser::mapFileParallel(path, threads)
+                          .materialize();
+                    }),
+                    expected));
+  }
+  for (size_t windowSize : {size_t(1), size_t(7), size_t(4096),
+                            size_t(1) << 20, size_t(64) << 20}) {
+    CHECK(sameParse(streamed(path, windowSize), expected));
+  }
+  CHECK(sameParse(capture([&] {
+                    return FileParser::parseFileTable(path).toStudents();
+                  }),
+                  expected));
+}
+
+// Строки с ошибками и особенностями записи: лишние поля, ID не числом,
+// со знаком и за пределами int, неверные даты, пропуски полей, табуляция
+const std::vector<std::string> oddLines = {
+    "",
+    "   ",
+    "\t",
+    "12 Ivan Ivanovich Ivanov 01.01.1988 extra",
+    "13 Ivan Ivanovich Ivanov 01.01.1988 extra more",
+    "abc Ivan Ivanovich Ivanov 01.01.1988",
+    "+14 Petr Petrovich Petrov 04.07.1988",
+    "-15 Petr Petrovich Petrov 04.07.1988",
+    "2147483647 Petr Petrovich Petrov 04.07.1988",
+    "2147483648 Petr Petrovich Petrov 04.07.1988",
+    "-2147483648 Petr Petrovich Petrov 04.07.1988",
+    "-2147483649 Petr Petrovich Petrov 04.07.1988",
+    "99999999999999999999 Petr Petrovich Petrov 04.07.1988",
+    "16Ivan Ivanovich Ivanov 01.01.1988",
+    "17 Ivan Ivanovich Ivanov 31.02.1988",
+    "18 Ivan Ivanovich Ivanov 1.13.1988",
+    "19 Ivan Ivanovich Ivanov 01.01.88",
+    "20 Ivan Ivanovich Ivanov 01-01-1988",
+    "21 Ivan Ivanovich 01.01.1988",
+    "22 Ivan",
+    "23",
+    "\t24\tIvan\tIvanovich\tIvanov\t01.01.1988\t",
+    "25  Ivan   Ivanovich  Ivanov  01.01.1988  ",
+    "26 Iv4n Ivanovich Ivanov 01.01.1988",
+    "27 Ivan Ivanovich Ivanov 29.02.2000",
+    "28 Ivan Ivanovich Ivanov 29.02.1900",
+};
+
+// Файл из count строк: записи randomRoster вперемешку со строками
+// oddLines; CRLF и LF вперемешку или только CRLF, с переводом строки в
+// конце или без него
+std::string makeText(size_t count, uint32_t seed, bool crlfOnly,
+                     bool finalNewline) {
+  std::vector<Student> students = test::randomRoster(count, seed);
+  std::mt19937 random(seed);
+  std::string text;
+  for (size_t i = 0; i < count; ++i) {
+    std::string line;
+    if (random() % 4 == 0) {
+      line = oddLines[random() % oddLines.size()];
+    } else {
+      const Student& student = students[i];
+      line = std::to_string(student.ids.front()) + " " + student.firstName +
+             " " + student.middleName + " " + student.lastName + " " +
+             student.birthDate.toString();
+    }
+    text += line;
+    if (i + 1 < count || finalNewline) {
+      text += crlfOnly || random() % 2 == 0 ? "\r\n" : "\n";
+    }
+  }
+  return text;
+}
+
+void writeText(const std::string& path, const std::string& text) {
+  std::ofstream file(path, std::ios::binary);
+  file << text;
+}
+
+void checkInputs() {
+  test::TempDir directory("parser-test");
+  std::string path = directory.file("students.txt");
+
+  // Крайние случаи целиком
+  for (const std::string& text :
+       {std::string(), std::string("\n"), std::string("\r\n"),
+        std::string("1 Ivan Ivanovich Ivanov 01.01.1988"),
+        std::string("1 Ivan Ivanovich Ivanov 01.01.1988\r"),
+        std::string("\n\n1 Ivan Ivanovich Ivanov 01.01.1988\n\n")}) {
+    writeText(path, text);
+    checkFile(path);
+  }
+  for (const std::string& line : oddLines) {
+    writeText(path, line);
+    checkFile(path);
+    writeText(path, line + "\r\n");
+    checkFile(path);
+  }
+
+  // Случайные файлы; последние — больше нескольких диапазонов потоков
+  // (MIN_CHUNK_SIZE = 1 МБ) и окон
+  const size_t counts[] = {10, 300, 5000, 120000};
+  uint32_t seed = 1;
+  for (size_t count : counts) {
+    for (bool crlfOnly : {false, true}) {
+      for (bool finalNewline : {false, true}) {
+        writeText(path, makeText(count, seed++, crlfOnly, finalNewline));
+        checkFile(path);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+int main() {
+  checkInputs();
+
+  // Файл, которого нет: пустой результат и одно и то же сообщение
+  test::TempDir directory("parser-test-missing");
+  checkFile(directory.file("missing.txt"));
+  return test::finish("ParserTest");
+}
@@ -0,0 +1,221 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+#include <zmq.hpp>
+
+#include "../client/StudentSnapshot.h"
+#include "../common/Protocol.h"
+#include "../server/StudentQueryService.h"
+#include "Check.h"
+#include "Rosters.h"
+
+// Сервис запросов через inproc:// с общим контекстом: ответы на запросы по
+// ID, началу ФИО и диапазону дат против перебора списка
+namespace {
+
+const char* const ENDPOINT = "inproc://query-test";
+
+struct Reply {
+  bool ok = false;
+  size_t total = 0;
+  std::vector<Student> students;
+};
+
+Reply ask(zmq::context_t& context, const std::string& request) {
+  zmq::socket_t socket(context, zmq::socket_type::req);
+  socket.set(zmq::sockopt::linger, 0);
+  socket.connect(ENDPOINT);
+  zmq::message_t requestMessage(request.data(), request.size());
+  socket.send(requestMessage, zmq::send_flags::none);
+
+  Reply reply;
+  zmq::pollitem_t items[] = {{socket.handle(), 0, ZMQ_POLLIN, 0}};
+  zmq::poll(items, 1, std::chrono::milliseconds(5000));
+  if (!(items[0].revents & ZMQ_POLLIN)) {
+    return reply;
+  }
+
+  zmq::message_t status;
+  zmq::message_t data;
+  socket.recv(status, zmq::recv_flags::none);
+  if (status.more()) {
+    socket.recv(data, zmq::recv_flags::none);
+  }
+  std::string statusText(static_cast<const char*>(status.data()),
+                         status.size());
+  reply.ok = statusText.rfind(protocol::OK, 0) == 0;
+  if (reply.ok) {
+    reply.total = std::strtoul(statusText.c_str() + protocol::OK.size(),
+                               nullptr, 10);
+    reply.students = StudentSnapshot::decode(std::move(data),
+                                             protocol::WireFormat::Binary)
+                         .toStudents();
+  }
+  return reply;
+}
+
+Reply ask(zmq::context_t& context, const protocol::Query& query) {
+  return ask(context, protocol::queryRequest(query));
+}
+
+// Ожидаемый ответ: строки, отобранные match, в порядке less (при равенстве
+// — по порядку списка), не больше QUERY_LIMIT
+template <typename Match, typename Less>
+Reply expected(const std::vector<Student>& students, Match match, Less less) {
+  std::vector<size_t> rows;
+  for (size_t row = 0; row < students.size(); ++row) {
+    if (match(students[row])) {
+      rows.push_back(row);
+    }
+  }
+  std::stable_sort(rows.begin(), rows.end(), [&](size_t a, size_t b) {
+    return less(students[a], students[b]);
+  });
+
+  Reply reply;
+  reply.ok = true;
+  reply.total = rows.size();
+  rows.resize(std::min(rows.size(), protocol::QUERY_LIMIT));
+  for (size_t row : rows) {
+    reply.students.push_back(students[row]);
+  }
+  return reply;
+}
+
+bool sameReply(const Reply& a, const Reply& b) {
+  return a.ok == b.ok && a.total == b.total &&
+         test::sameRoster(a.students, b.students);
+}
+
+bool byName(const Student& a, const Student& b) {
+  return a.getFullName() < b.getFullName();
+}
+
+bool byDateAndName(const Student& a, const Student& b) {
+  if (a.birthDate.pack() != b.birthDate.pack()) {
+    return a.birthDate.pack() < b.birthDate.pack();
+  }
+  return byName(a, b);
+}
+
+// Список с ID, повторенными в разных записях и внутри одной записи
+std::vector<Student> makeRoster(uint32_t seed) {
+  std::vector<Student> students = test::randomRoster(3000, seed);
+  Student repeated = students[10];
+  repeated.ids = {5, 9000, 9000};
+  repeated.lastName = "Ivanova";
+  students.push_back(repeated);
+  students[20].ids.push_back(5);
+  return students;
+}
+
+void checkQueries(zmq::context_t& context,
+                  const std::vector<Student>& students) {
+  for (int id : {1, 5, 9000, 3000, 3001, 0, -1}) {
+    protocol::Query query;
+    query.kind = protocol::QueryKind::Id;
+    query.id = id;
+    Reply reply = expected(
+        students,
+        [&](const Student& student) {
+          return std::count(student.ids.begin(), student.ids.end(), id) > 0;
+        },
+        [](const Student&, const Student&) { return false; });
+    CHECK(sameReply(ask(context, query), reply));
+  }
+
+  for (const std::string& prefix :
+       {std::string("I"), std::string("Ivan"), std::string("Ivan "),
+        std::string("Ivan Ivanovich Ivanov"), std::string("Ёж"),
+        std::string("Ян P"), students[7].getFullName(),
+        std::string("Nobody")}) {
+    protocol::Query query;
+    query.kind = protocol::QueryKind::Name;
+    query.namePrefix = prefix;
+    Reply reply = expected(
+        students,
+        [&](const Student& student) {
+          return student.getFullName().rfind(prefix, 0) == 0;
+        },
+        byName);
+    CHECK(sameReply(ask(context, query), reply));
+  }
+
+  const Date ranges[][2] = {{{1, 1, 1980}, {1, 1, 1980}},
+                            {{1, 1, 1980}, {28, 2, 1980}},
+                            {{5, 1, 1980}, {14, 1, 1980}},
+                            {{1, 1, 1900}, {31, 12, 2010}},
+                            {{2, 2, 1980}, {1, 2, 1980}},
+                            {{1, 1, 1999}, {31, 12, 1999}}};
+  for (const auto& range : ranges) {
+    protocol::Query query;
+    query.kind = protocol::QueryKind::Dates;
+    query.from = range[0];
+    query.to = range[1];
+    Reply reply = expected(
+        students,
+        [&](const Student& student) {
+          uint32_t date = student.birthDate.pack();
+          return date >= range[0].pack() && date <= range[1].pack();
+        },
+        byDateAndName);
+    CHECK(sameReply(ask(context, query), reply));
+  }
+
+  // Диапазон всех дат выше — больше QUERY_LIMIT записей; пустое начало
+  // ФИО и поврежденные запросы — ошибка
+  CHECK(!ask(context, std::string("QUERY NAME ")).ok);
+  CHECK(!ask(context, std::string("QUERY")).ok);
+  CHECK(!ask(context, std::string("QUERY ID x")).ok);
+  CHECK(!ask(context, std::string("SNAPSHOT")).ok);
+}
+
+void checkIndex(const std::vector<Student>& students) {
+  std::shared_ptr<const StudentIndex> index;
+  {
+    test::QuietOutput quiet(std::cerr);  // предупреждение о повторах ID
+    index = std::make_shared<const StudentIndex>(
+        std::make_shared<const std::vector<Student>>(students));
+  }
+  CHECK(index->idCollisions() == 2);
+
+  size_t total = 0;
+  std::vector<uint32_t> rows = index->findById(5, 1, total);
+  CHECK(total == 3);
+  CHECK(rows == std::vector<uint32_t>{4});
+  rows = index->findById(9000, protocol::QUERY_LIMIT, total);
+  CHECK(total == 1);
+  CHECK(rows == std::vector<uint32_t>{3000});
+}
+
+}  // namespace
+
+int main() {
+  auto context = std::make_shared<zmq::context_t>(1);
+  std::vector<Student> students = makeRoster(3);
+  std::vector<Student> updated = makeRoster(4);
+  {
+    test::QuietOutput quiet;
+    StudentQueryService service(ENDPOINT);
+    service.setContext(context);
+    {
+      test::QuietOutput quietErrors(std::cerr);
+      service.start(std::make_shared<const std::vector<Student>>(students));
+    }
+    checkQueries(*context, students);
+
+    // Новый список заменяет прежний для следующих запросов
+    {
+      test::QuietOutput quietErrors(std::cerr);
+      service.update(std::make_shared<const std::vector<Student>>(updated));
+    }
+    checkQueries(*context, updated);
+    service.stop();
+  }
+  checkIndex(students);
+  return test::finish("QueryServiceTest");
+}
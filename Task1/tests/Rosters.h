@@ -0,0 +1,109 @@
+#pragma once
+
+#include <unistd.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../common/Student.h"
+
+// Тестовые списки студентов
+namespace test {
+
+// Случайный список из count записей с одним ID каждая (ID с firstId по
+// порядку). Имена и даты берутся из небольших наборов, поэтому в списке
+// много одинаковых ФИО и дубликатов (то же ФИО и та же дата); dateCount —
+// сколько разных дат рождения. Среди имен — латиница и кириллица, имена,
+// которые являются началом других, и имена, различающиеся только регистром
+// или буквой Ё. Все имена проходят Validator (байты кириллицы из его
+// набора), поэтому список можно записать в файл и разобрать
+inline std::vector<Student> randomRoster(size_t count, uint32_t seed,
+                                         int firstId = 1,
+                                         int dateCount = 40) {
+  static const std::vector<std::string> firstNames = {
+      "Ivan", "Ivanna", "Iva", "ivan", "Petr", "Zed", "adam", "Adam",
+      "Иван", "Ян", "Анна", "Ан", "Ёж", "ёж", "Еж", "Пёла", "Пела", "Яков"};
+  static const std::vector<std::string> middleNames = {
+      "Ivanovich", "Petrovich", "P", "Ивановна", "Лёвовна", "Леновна"};
+  static const std::vector<std::string> lastNames = {
+      "Ivanov", "Ivanova", "Petrov", "Zukov", "Иванов", "Ежов", "Ёлкин",
+      "Лебедев", "Яковлев", "Ан"};
+
+  std::mt19937 random(seed);
+  std::vector<Student> students(count);
+  for (size_t i = 0; i < count; ++i) {
+    Student& student = students[i];
+    student.ids.push_back(firstId + static_cast<int>(i));
+    student.firstName = firstNames[random() % firstNames.size()];
+    student.middleName = middleNames[random() % middleNames.size()];
+    student.lastName = lastNames[random() % lastNames.size()];
+    int date = static_cast<int>(random() % dateCount);
+    student.birthDate = Date{1 + date % 28, 1 + date / 28 % 12,
+                             1980 + date / (28 * 12) % 30};
+  }
+  return students;
+}
+
+// Запись списка в текстовом формате входных файлов сервера
+inline void writeRoster(const std::string& path,
+                        const std::vector<Student>& students) {
+  std::ofstream file(path);
+  for (const auto& student : students) {
+    for (int id : student.ids) {
+      file << id << " " << student.firstName << " " << student.middleName
+           << " " << student.lastName << " " << student.birthDate.toString()
+           << "\n";
+    }
+  }
+}
+
+inline bool sameStudent(const Student& a, const Student& b) {
+  return a.ids == b.ids && a.firstName == b.firstName &&
+         a.middleName == b.middleName && a.lastName == b.lastName &&
+         a.birthDate == b.birthDate;
+}
+
+inline bool sameRoster(const std::vector<Student>& a,
+                       const std::vector<Student>& b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (!sameStudent(a[i], b[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Временный каталог теста, удаляется вместе с содержимым
+class TempDir {
+ public:
+  explicit TempDir(const std::string& name)
+      : path_(std::filesystem::temp_directory_path() /
+              (name + "-" + std::to_string(::getpid()))) {
+    std::filesystem::remove_all(path_);
+    std::filesystem::create_directories(path_);
+  }
+
+  ~TempDir() {
+    std::error_code error;
+    std::filesystem::remove_all(path_, error);
+  }
+
+  TempDir(const TempDir&) = delete;
+  TempDir& operator=(const TempDir&) = delete;
+
+  std::string file(const std::string& name) const {
+    return (path_ / name).string();
+  }
+
+ private:
+  std::filesystem::path path_;
+};
+
+}  // namespace test
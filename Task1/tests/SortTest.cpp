@@ -0,0 +1,262 @@
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../client/RadixSorter.h"
+#include "../client/StudentSorter.h"
+#include "../common/Collation.h"
+#include "Check.h"
+#include "Rosters.h"
+
+// Сортировка по ФИО (RadixSorter, слияние отрезков потоков по merge path,
+// RussianCollation) против std::stable_sort строк getFullName() и
+// эталонного сравнения по русскому алфавиту
+namespace {
+
+// Эталонный порядок русского алфавита: буквы по таблице, без ключей
+// RussianCollation. Основной уровень — буквы без учета регистра (части
+// ФИО разделены значением меньше любой буквы), затем регистр (строчная
+// раньше прописной). Имена тестов состоят только из букв
+struct ReferenceKey {
+  std::vector<int> letters;
+  std::vector<int> cases;
+
+  bool operator<(const ReferenceKey& other) const {
+    if (letters != other.letters) {
+      return letters < other.letters;
+    }
+    return cases < other.cases;
+  }
+};
+
+ReferenceKey referenceKey(const Student& student) {
+  static const std::u32string upper =
+      U"ABCDEFGHIJKLMNOPQRSTUVWXYZАБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ";
+  static const std::u32string lower =
+      U"abcdefghijklmnopqrstuvwxyzабвгдеёжзийклмнопрстуфхцчшщъыьэюя";
+
+  ReferenceKey key;
+  const std::string* parts[] = {&student.firstName, &student.middleName,
+                                &student.lastName};
+  for (size_t part = 0; part < 3; ++part) {
+    if (part > 0) {
+      key.letters.push_back(-1);
+    }
+    const std::string& text = *parts[part];
+    for (size_t i = 0; i < text.size();) {
+      // Буква UTF-8: один байт (латиница) или два (кириллица)
+      unsigned char byte = static_cast<unsigned char>(text[i]);
+      char32_t code = byte;
+      if (byte >= 0xC0 && i + 1 < text.size()) {
+        code = ((byte & 0x1Fu) << 6) | (text[i + 1] & 0x3Fu);
+        i += 2;
+      } else {
+        i += 1;
+      }
+      size_t position = upper.find(code);
+      if (position != std::u32string::npos) {
+        key.cases.push_back(2);
+      } else {
+        position = lower.find(code);
+        key.cases.push_back(1);
+      }
+      key.letters.push_back(static_cast<int>(position));
+    }
+  }
+  return key;
+}
+
+// Порядок строк, который должна дать устойчивая сортировка по less
+template <typename Less>
+std::vector<uint32_t> stableOrder(size_t count, Less less) {
+  std::vector<uint32_t> rows(count);
+  std::iota(rows.begin(), rows.end(), 0);
+  std::stable_sort(rows.begin(), rows.end(), less);
+  return rows;
+}
+
+std::vector<uint32_t> byteOrder(const std::vector<Student>& students) {
+  std::vector<std::string> names;
+  names.reserve(students.size());
+  for (const auto& student : students) {
+    names.push_back(student.getFullName());
+  }
+  return stableOrder(names.size(), [&](uint32_t a, uint32_t b) {
+    return names[a] < names[b];
+  });
+}
+
+std::vector<uint32_t> russianOrder(const std::vector<Student>& students) {
+  std::vector<ReferenceKey> keys;
+  keys.reserve(students.size());
+  for (const auto& student : students) {
+    keys.push_back(referenceKey(student));
+  }
+  return stableOrder(keys.size(), [&](uint32_t a, uint32_t b) {
+    return keys[a] < keys[b];
+  });
+}
+
+// Случайные имена: общее начало из небольшого набора (префиксы из
+// PREFIX_BYTES байт часто равны) и случайные буквы после него
+std::vector<Student> randomNames(size_t count, uint32_t seed) {
+  static const std::vector<std::string> stems = {
+      "", "Aleksandr", "Aleksandra", "Константин", "Ё", "Е", "z"};
+  static const std::vector<std::string> letters = {
+      "a", "b", "y", "z", "A", "Z", "а", "б", "е", "ё", "я", "А", "Е", "Ё",
+      "Ж", "Я"};
+
+  std::mt19937 random(seed);
+  auto name = [&] {
+    std::string result = stems[random() % stems.size()];
+    for (size_t length = random() % 5; length > 0; --length) {
+      result += letters[random() % letters.size()];
+    }
+    return result;
+  };
+
+  std::vector<Student> students(count);
+  for (size_t i = 0; i < count; ++i) {
+    students[i].ids.push_back(static_cast<int>(i + 1));
+    students[i].firstName = name();
+    students[i].middleName = name();
+    students[i].lastName = name();
+  }
+  return students;
+}
+
+// Списки: случайные имена, много одинаковых ФИО (randomRoster) и одно ФИО
+// на всех
+std::vector<std::vector<Student>> rosters(size_t count, uint32_t seed) {
+  std::vector<Student> same = test::randomRoster(count, seed);
+  for (auto& student : same) {
+    student.firstName = "Ivan";
+    student.middleName = "Ivanovich";
+    student.lastName = "Ivanov";
+  }
+  return {randomNames(count, seed), test::randomRoster(count, seed),
+          std::move(same)};
+}
+
+std::vector<uint32_t> idsInOrder(const std::vector<Student>& students,
+                                 const std::vector<uint32_t>& order) {
+  std::vector<uint32_t> ids;
+  ids.reserve(order.size());
+  for (uint32_t row : order) {
+    ids.push_back(static_cast<uint32_t>(students[row].ids.front()));
+  }
+  return ids;
+}
+
+std::vector<uint32_t> ids(const std::vector<Student>& students) {
+  std::vector<uint32_t> result;
+  result.reserve(students.size());
+  for (const auto& student : students) {
+    result.push_back(static_cast<uint32_t>(student.ids.front()));
+  }
+  return result;
+}
+
+// Размеры по обе стороны PARALLEL_THRESHOLD: меньшие сортируются в одном
+// потоке, большие — отрезками с последующим слиянием
+void checkOrder() {
+  const size_t threshold = RadixSorter::PARALLEL_THRESHOLD;
+  const size_t sizes[] = {0,   1,   2,    RadixSorter::SMALL_RANGE - 1,
+                          RadixSorter::SMALL_RANGE + 1, 5000,
+                          threshold - 1, threshold, threshold + 4321};
+  for (size_t size : sizes) {
+    for (const auto& students : rosters(size, static_cast<uint32_t>(size))) {
+      std::vector<uint32_t> bytes = byteOrder(students);
+      std::vector<uint32_t> russian = russianOrder(students);
+      CollationKeys keys;
+      keys.build(students.size(),
+                 [&](size_t row) { return students[row].fullNameRef(); });
+
+      for (unsigned threads : {1u, 2u, 3u, 8u, 0u}) {
+        CHECK(RadixSorter::order(
+                  students.size(),
+                  [&](size_t row) { return students[row].fullNameRef(); },
+                  threads) == bytes);
+        CHECK(RadixSorter::order(
+                  keys.size(), [&](size_t row) { return keys[row]; },
+                  threads) == russian);
+      }
+
+      // StudentSorter переставляет сами записи в том же порядке
+      std::vector<Student> sorted = students;
+      std::vector<Student> sortedRussian = students;
+      {
+        test::QuietOutput quiet;
+        StudentSorter::sortByFullName(sorted, 3);
+        StudentSorter::sortByFullName(sortedRussian, 3, NameOrder::Russian);
+      }
+      CHECK(ids(sorted) == idsInOrder(students, bytes));
+      CHECK(ids(sortedRussian) == idsInOrder(students, russian));
+    }
+  }
+}
+
+Student named(const std::string& first, const std::string& middle,
+              const std::string& last) {
+  Student student;
+  student.firstName = first;
+  student.middleName = middle;
+  student.lastName = last;
+  return student;
+}
+
+// Порядок русского алфавита на именах, где он расходится с порядком байт:
+// Ё сразу после Е (в UTF-8 — до А или после Я), латиница раньше
+// кириллицы, строчная раньше прописной при тех же буквах, более короткое
+// имя раньше продолжения
+void checkRussianCollation() {
+  const std::vector<Student> expected = {
+      named("adam", "A", "A"),     named("Adam", "A", "A"),
+      named("Zed", "A", "A"),      named("zed", "B", "A"),
+      named("Ан", "Я", "Я"),       named("Анна", "A", "A"),
+      named("Анна", "Ёлкина", "A"), named("Анна", "Ёлкина", "Z"),
+      named("Анна", "Ж", "A"),     named("Еж", "A", "A"),
+      named("еж", "B", "A"),       named("Ёж", "A", "A"),
+      named("ёж", "A", "B"),       named("Ёлкин", "A", "A"),
+      named("Жук", "A", "A"),      named("Яков", "A", "A"),
+      named("яков", "A", "Б"),
+  };
+  for (size_t i = 0; i + 1 < expected.size(); ++i) {
+    CHECK(RussianCollation::key(expected[i].fullNameRef()) <
+          RussianCollation::key(expected[i + 1].fullNameRef()));
+    CHECK(referenceKey(expected[i]) < referenceKey(expected[i + 1]));
+  }
+
+  std::vector<Student> shuffled = expected;
+  for (size_t i = 0; i < shuffled.size(); ++i) {
+    shuffled[i].ids.push_back(static_cast<int>(i));
+  }
+  std::mt19937 random(5);
+  for (int round = 0; round < 20; ++round) {
+    std::shuffle(shuffled.begin(), shuffled.end(), random);
+    std::vector<Student> sorted = shuffled;
+    {
+      test::QuietOutput quiet;
+      StudentSorter::sortByFullName(sorted, 1, NameOrder::Russian);
+    }
+    std::vector<uint32_t> expectedIds(expected.size());
+    std::iota(expectedIds.begin(), expectedIds.end(), 0);
+    CHECK(ids(sorted) == expectedIds);
+  }
+
+  // Одинаковые ФИО — одинаковые ключи, разные — разные
+  CHECK(RussianCollation::key(named("Ёж", "A", "B").fullNameRef()) ==
+        RussianCollation::key(named("Ёж", "A", "B").fullNameRef()));
+  CHECK(RussianCollation::key(named("Ёж", "A", "B").fullNameRef()) !=
+        RussianCollation::key(named("Ёж", "AB", "").fullNameRef()));
+}
+
+}  // namespace
+
+int main() {
+  checkOrder();
+  checkRussianCollation();
+  return test::finish("SortTest");
+}
@@ -0,0 +1,131 @@
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../common/Validator.h"
+#include "Check.h"
+
+// Прежняя проверка даты на std::regex: эталон для сравнения с разбором
+// таблицами (Validator::parseDate, tryParseDate, isValidDate)
+namespace legacy {
+
+bool isLeapYear(int year) {
+  return (year % 4 == 0 && year % 100 != 0) || (year % 400 == 0);
+}
+
+bool isValidDate(int day, int month, int year) {
+  if (year < 1900 || year > 2010) {
+    return false;
+  }
+  if (month < 1 || month > 12) {
+    return false;
+  }
+  int daysInMonth[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  if (month == 2 && isLeapYear(year)) {
+    daysInMonth[1] = 29;
+  }
+  return day >= 1 && day <= daysInMonth[month - 1];
+}
+
+bool parseDate(const std::string& dateStr, Date& date) {
+  static const std::regex datePattern(R"((\d{1,2})\.(\d{1,2})\.(\d{4}))");
+  std::smatch match;
+  if (!std::regex_match(dateStr, match, datePattern)) {
+    return false;
+  }
+  date.day = std::stoi(match[1]);
+  date.month = std::stoi(match[2]);
+  date.year = std::stoi(match[3]);
+  return isValidDate(date.day, date.month, date.year);
+}
+
+}  // namespace legacy
+
+namespace {
+
+// Одна строка даты: оба разбора должны согласиться в результате и, для
+// допустимой даты, в ее значении
+void checkDate(const std::string& text) {
+  Date expected{};
+  bool valid = legacy::parseDate(text, expected);
+
+  Date parsed{};
+  Date tried{};
+  bool parsedOk = Validator::parseDate(text, parsed);
+  bool triedOk = Validator::tryParseDate(text, tried);
+  if (parsedOk != valid || triedOk != valid) {
+    std::cerr << "   дата: \"" << text << "\"" << std::endl;
+  }
+  CHECK(parsedOk == valid);
+  CHECK(triedOk == valid);
+  if (valid) {
+    CHECK(parsed == expected);
+    CHECK(tried == expected);
+  }
+}
+
+std::string twoDigits(int value) {
+  return (value < 10 ? "0" : "") + std::to_string(value);
+}
+
+// Каждый день 1900-2100 (и соседние значения дня и месяца) в записи с
+// ведущими нулями и без них
+void checkCalendar() {
+  for (int year = 1900; year <= 2100; ++year) {
+    for (int month = 0; month <= 13; ++month) {
+      for (int day = 0; day <= 32; ++day) {
+        CHECK(Validator::isValidDate(day, month, year) ==
+              legacy::isValidDate(day, month, year));
+
+        std::string yyyy = std::to_string(year);
+        checkDate(twoDigits(day) + "." + twoDigits(month) + "." + yyyy);
+        checkDate(std::to_string(day) + "." + std::to_string(month) + "." +
+                  yyyy);
+      }
+    }
+  }
+}
+
+void checkMalformed() {
+  const std::vector<std::string> inputs = {
+      "",           ".",           "..",          "1.1.",
+      "01.01.88",   "01.01.19888", "001.01.1988", "01.001.1988",
+      "1988.01.01", "01-01-1988",  "01/01/1988",  "01.01.1988 ",
+      " 01.01.1988", "01..01.1988", "01.01..1988", "a1.01.1988",
+      "01.0b.1988", "01.01.198c",  "+1.01.1988",  "-1.01.1988",
+      "1.-1.1988",  "01.01.-988",  "31.12.2010.", "29.02.2000x",
+      "43.01.1988", "04.5.1987",   "00.00.0000",  "99.99.9999",
+      "1.1.1900",   "31.12.2010",  "1.1.2011",    "31.12.1899",
+      "29.02.1900", "29.02.2000",  "29.02.2004",  "30.02.2004",
+      "31.04.2001", "31.06.2001",  "31.09.2001",  "31.11.2001",
+  };
+  for (const auto& input : inputs) {
+    checkDate(input);
+  }
+
+  // Невидимые и не-ASCII байты вместо цифр и точек
+  const char replacements[] = {'\0', '\t', ',', ':', ' ', '\x7F', '\xD0'};
+  const std::string base = "15.06.1990";
+  for (size_t position = 0; position < base.size(); ++position) {
+    for (char replacement : replacements) {
+      std::string input = base;
+      input[position] = replacement;
+      checkDate(input);
+    }
+    checkDate(base.substr(0, position));
+    checkDate(base.substr(position));
+  }
+}
+
+}  // namespace
+
+int main() {
+  // Сообщения об ошибках даты не нужны: сравниваются только результаты
+  std::ostringstream messages;
+  Validator::ErrorRedirect redirect(messages);
+
+  checkCalendar();
+  checkMalformed();
+  return test::finish("ValidatorTest");
+}